@@ -1,4 +1,4 @@
-% [ijw_out, wgt, deg_out] = bmatch_ijw(ijw_in, deg_bdd, [method], [verbose])
+% [ijw_out, wgt, deg_out, profile] = bmatch_ijw(ijw_in, deg_bdd, [method], [verbose], [seed], [threads], [options])
 %
 %Sparse interface for Bmatching.  For details, see: BMATCH_MATRIX
 %
@@ -7,9 +7,26 @@
 %       - List of edges with non-zero weight
 %       - Edge weights specified more than once are added together
 %
+%   SEED : [0] - ties between equal weights broken by edge index, 
+%       otherwise by a permutation of the edges drawn from SEED
+%
+%   THREADS : [0] - with cell arrays IJW_IN and DEG_BDD of problems of the
+%       same size, the problems are solved concurrently by a pool of
+%       THREADS native threads, 0 => one per core; IJW_OUT, DEG_OUT and
+%       PROFILE are then cell arrays, and WGT an array, of the same size
+%
+%   OPTIONS : [struct()] - solver options of the command line tool, as
+%       fields: prune, queue, primal_dual and bipartite (the left nodes of
+%       method 7 are 1..bipartite, -1 => a 2-colouring)
+%
 %   IJW_OUT : N_bmatch x 3 [u, v, wgt]
 %       - List of edges in matching
 %
+%   PROFILE : string
+%       - JSON object with the wall-clock time of each solver phase 
+%         (preprocess, init, solve, solution, weight) and, for the exact 
+%         methods, the goblin internal timers
+%
 %Example 1: shows how to format the input for the sparse routine
 %   
 %W = [0  5 10 4;
@@ -50,7 +67,15 @@
 %[ijw_out, wgt, deg_out] = bmatch_ijw([Iblk, Jblk, Vblk], deg_bdd_big, 5, 1);
 %
 %
-function [ijw_out,wgt,deg_out] = bmatch_ijw(ijw_in,deg_bdd,in_method,in_verbose)
+%Example 3: solves many problems in one call, on a pool of threads (this
+%       example requires variables defined in the first example)
+%
+%ijw_cell = repmat({[I, J, V]}, 1, 1000);
+%deg_cell = repmat({deg_bdd}, 1, 1000);
+%[ijw_out, wgt, deg_out] = bmatch_ijw(ijw_cell, deg_cell, 6, 0, 0, 4);
+%
+%
+function [ijw_out,wgt,deg_out,profile] = bmatch_ijw(ijw_in,deg_bdd,in_method,in_verbose,in_seed,in_threads,in_options)
 %
 method = 1;
 if nargin>=3
@@ -61,14 +86,63 @@ vvrb = 0;
 if nargin>=4
     vvrb = in_verbose;
 end
+seed = 0;
+if nargin>=5
+    seed = in_seed;
+end
+threads = 0;
+if nargin>=6
+    threads = in_threads;
+end
+options = struct();
+if nargin>=7
+    options = in_options;
+end
+%
+% many problems
+if iscell(ijw_in)
+    N_cell = cell(size(ijw_in));
+    ijw_mex = cell(size(ijw_in));
+    deg_mex = cell(size(deg_bdd));
+    for k = 1:numel(ijw_in)
+        N_cell{k} = max(max(ijw_in{k}(:,[1,2])));
+        ijw_mex{k} = full(ijw_in{k});
+        ijw_mex{k}(:,[1,2]) = ijw_mex{k}(:,[1,2]) - 1;
+        deg_mex{k} = full(deg_bdd{k}');
+    end
+    if nargout>=4
+        [ijw_out,wgt,success,profile] = bmatch_ijw_mex(ijw_mex,deg_mex,method,vvrb,seed,threads,options);
+    else
+        [ijw_out,wgt,success] = bmatch_ijw_mex(ijw_mex,deg_mex,method,vvrb,seed,threads,options);
+    end
+    deg_out = cell(size(ijw_out));
+    for k = 1:numel(ijw_out)
+        [ijw_out{k}, deg_out{k}] = bmatch_ijw_degrees(ijw_out{k}, N_cell{k});
+    end
+    return;
+end
 %
 % max node number
 N = max(max(ijw_in(:,[1,2])));
 %
 % convert to 0-based indices
 ijw_in(:,[1,2]) = ijw_in(:,[1,2]) - 1;
-[ijw_out,wgt,success] = bmatch_ijw_mex(full(ijw_in),full(deg_bdd'),method,vvrb);
+if nargout>=4
+    [ijw_out,wgt,success,profile] = bmatch_ijw_mex(full(ijw_in),full(deg_bdd'),method,vvrb,seed,threads,options);
+else
+    [ijw_out,wgt,success] = bmatch_ijw_mex(full(ijw_in),full(deg_bdd'),method,vvrb,seed,threads,options);
+end
+%
+%
+[ijw_out, deg_out] = bmatch_ijw_degrees(ijw_out, N);
 %
+return;
+%%%%%%%%%%
+%
+
+
+% 1-based b-matching and its degrees
+function [ijw_out,deg_out] = bmatch_ijw_degrees(ijw_out,N)
 %
 if ~isempty(ijw_out)
     ijw_out(:,[1,2]) = ijw_out(:,[1,2]) + 1;
@@ -1,4 +1,4 @@
-% [Ymat, wgt, deg_out] = bmatch_matrix(Wmat, deg_bdd, [method], [verbose])
+% [Ymat, wgt, deg_out] = bmatch_matrix(Wmat, deg_bdd, [method], [verbose], [seed])
 %
 %B-matching on an undirected non-bipartite graph.
 %
@@ -14,6 +14,8 @@
 %    3. greedy 1/2 approximation to maxwgt solution
 %    4. greedy 1/2 approximation to maxwgt solution with recursion
 %    5. bipartite relaxation to maxwgt solution using belief propagation
+%    6. parallel b-suitor 1/2 approximation to maxwgt solution
+%    7. exact maxwgt solution of a bipartite graph by min-cost flow
 %           
 %Notes: 
 %       Self-loops are handled: a self-loop increases the degree of a node
@@ -25,8 +27,10 @@
 %       belief propagation is used, whose output is not necessarily
 %       symmetric.  For BP, the output weight is 0.5 * sum_{i,j} Wij Yij.
 %
-%       The lower bounds are ignored by methods 3-5. Bipartite relaxation
+%       The lower bounds are ignored by methods 5-6. Bipartite relaxation
 %       assumes that the degree upper bounds can be met with equality.
+%       Methods 3-4 fill the nodes below their lower bounds after the greedy
+%       pass, and report the total deficit if some bounds are still not met.
 
 %
 %Parameters:
@@ -34,10 +38,13 @@
 %
 %   DEG_BDD : scalar, Nx1, 1xN, Nx2 or 2xN
 %
-%   METHOD : scalar 1-5
+%   METHOD : scalar 1-7
 %
 %   VERBOSE : [1] - verbose, 0 - quiet, 2 - turn-on mex verbosity
 %
+%   SEED : [0] - ties between equal weights broken by edge index,
+%       otherwise by a permutation of the edges drawn from SEED
+%
 %   Ymat : N x N [matching]
 %
 %   WEIGHT : scalar
@@ -111,7 +118,7 @@
 %W1(logical(W1)) = W1(logical(W1)) + 1.0;
 %[Y1,wgt1,deg_out1]=bmatch_matrix(W1,deg,1);num2str(Y1,-5),num2str(deg_out1,-3)
 %
-function [Ymat, wgt, deg_out] = bmatch_matrix(W, deg_bdd, in_method, in_verbose)
+function [Ymat, wgt, deg_out] = bmatch_matrix(W, deg_bdd, in_method, in_verbose, in_seed)
 
 %
 method = 1;
@@ -124,6 +131,11 @@ if (nargin>=4) & (~isempty(in_verbose))
     verbose = in_verbose;
 end
 %
+seed = 0;
+if (nargin>=5) & (~isempty(in_seed))
+    seed = in_seed;
+end
+%
 N = size(W,1);
 %
 wrong_size_deg_bdd_msg = [' bmatch_matrix> deg_bdd must be scalar, Nx1, 1xN, Nx2 or 2xN'];
@@ -152,7 +164,7 @@ is_w_sparse = issparse(W);
 ijw_in = [I, J, V];
 
 % solve
-[ijw_out, wgt, deg_out] = bmatch_ijw(ijw_in, deg_bdd, method, verbose);
+[ijw_out, wgt, deg_out] = bmatch_ijw(ijw_in, deg_bdd, method, verbose, seed);
 
 %
 Ymat = sparse(ijw_out(:,1), ijw_out(:,2), 1.0, N, N); 
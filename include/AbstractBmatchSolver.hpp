@@ -9,12 +9,13 @@
 #include <string>
 using namespace std;
 #include "Vector.hpp"
+#include "SolveProfile.hpp"
 
 
 class AbstractBmatchSolver
 {
     public:
-        AbstractBmatchSolver() : description_str("bmatch interface") { };
+        AbstractBmatchSolver() : description_str("bmatch interface"), seed(0) { };
 
         virtual ~AbstractBmatchSolver() { };
 
@@ -24,11 +25,33 @@ class AbstractBmatchSolver
          * a single interface that does everything
          * returns success (1) or failure (0)
          * */
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose) = 0;
+        int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* 
+         * the same, reading the ijw through a view, e.g. the columns of a 
+         * MATLAB array in place; the solvers keep only their filtered 
+         * upper triangle copy of it
+         * */
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose) = 0;
+
+        /* 
+         * rough estimate of the peak memory (bytes) of a solve of num_ijw
+         * entries between num_node nodes, from the sizes of the arrays the
+         * solver allocates, so that it can be checked before solving
+         * */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
 
         /* description string */
         string description_str;
 
+        /* wall-clock phases and counters of the solves, see SolveProfile */
+        SolveProfile profile;
+
+        /* ties between equal weights are broken by edge index if seed is 0, 
+         * and otherwise by a permutation of the edges drawn from seed, see 
+         * seeded_rank; the goblin methods ignore it */
+        unsigned int seed;
+
 };
 
 #endif
@@ -24,7 +24,7 @@ class BmatchSolver : public AbstractBmatchSolver
          * a single interface that does everything
          * returns success (1) or failure (0)
          * */
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
 
 
     private:
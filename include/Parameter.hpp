@@ -6,6 +6,9 @@
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 using namespace std;
 
 #include "method_names.hpp"
@@ -56,11 +59,32 @@ public:
     string  weights;
     string  degrees;
     string  output;
+    string  profile;
+    string  initial;
     int     const_u;
     int     const_l;
     int     sparse;
     int     method;
     int     verbose;
+    int     queue;
+    int     primal_dual;
+    int     threads;
+    int     improve;
+    double  eps;
+    double  time_limit;
+    int     stream;
+    double  stream_eps;
+    double  topk;
+    int     topk_verify;
+    int     reorder;
+    int     seed;
+    int     prune;
+    int     bipartite;
+    int     stats;
+    double  max_mem;
+    string  serve;
+    int     workers;
+    double  accuracy;
 
 };
 
@@ -73,11 +97,32 @@ init_0()
     weights     = string("");
     degrees     = string("");
     output      = string("");
+    profile     = string("");
+    initial     = string("");
     const_u     = 0;
     const_l     = 0;
     sparse      = 0;
     method      = 0;
     verbose     = 0;
+    queue       = -1;
+    primal_dual = -1;
+    threads     = 0;
+    improve     = 0;
+    eps         = 0.0;
+    time_limit  = 0.0;
+    stream      = 0;
+    stream_eps  = 0.1;
+    topk        = 0.0;
+    topk_verify = 0;
+    reorder     = 0;
+    seed        = 0;
+    prune       = 0;
+    bipartite   = -1;
+    stats       = 0;
+    max_mem     = 0.0;
+    serve       = string("");
+    workers     = 0;
+    accuracy    = 0.5;
 }
 
 
@@ -136,6 +181,12 @@ init(int argc, char* argv[])
         if (string("-o")==argv[i]) {
             output = string(argv[++i]); continue;
         }
+        if (string("-profile")==argv[i]) {
+            profile = string(argv[++i]); continue;
+        }
+        if (string("-p")==argv[i]) {
+            profile = string(argv[++i]); continue;
+        }
         if (string("-const_u")==argv[i]) {
             const_u = atoi(argv[++i]); continue;
         }
@@ -166,6 +217,126 @@ init(int argc, char* argv[])
         if (string("-v")==argv[i]) {
             verbose = atoi(argv[++i]); continue;
         }
+        if (string("-queue")==argv[i]) {
+            queue = atoi(argv[++i]); continue;
+        }
+        if (string("-q")==argv[i]) {
+            queue = atoi(argv[++i]); continue;
+        }
+        if (string("-primal_dual")==argv[i]) {
+            primal_dual = atoi(argv[++i]); continue;
+        }
+        if (string("-pd")==argv[i]) {
+            primal_dual = atoi(argv[++i]); continue;
+        }
+        if (string("-threads")==argv[i]) {
+            threads = atoi(argv[++i]); continue;
+        }
+        if (string("-t")==argv[i]) {
+            threads = atoi(argv[++i]); continue;
+        }
+        if (string("-improve")==argv[i]) {
+            improve = atoi(argv[++i]); continue;
+        }
+        if (string("-im")==argv[i]) {
+            improve = atoi(argv[++i]); continue;
+        }
+        if (string("-eps")==argv[i]) {
+            eps = atof(argv[++i]); continue;
+        }
+        if (string("-e")==argv[i]) {
+            eps = atof(argv[++i]); continue;
+        }
+        if (string("-time_limit")==argv[i]) {
+            time_limit = atof(argv[++i]); continue;
+        }
+        if (string("-tl")==argv[i]) {
+            time_limit = atof(argv[++i]); continue;
+        }
+        if (string("-initial")==argv[i]) {
+            initial = string(argv[++i]); continue;
+        }
+        if (string("-in")==argv[i]) {
+            initial = string(argv[++i]); continue;
+        }
+        if (string("-stream")==argv[i]) {
+            stream = atoi(argv[++i]); continue;
+        }
+        if (string("-st")==argv[i]) {
+            stream = atoi(argv[++i]); continue;
+        }
+        if (string("-stream_eps")==argv[i]) {
+            stream_eps = atof(argv[++i]); continue;
+        }
+        if (string("-se")==argv[i]) {
+            stream_eps = atof(argv[++i]); continue;
+        }
+        if (string("-topk")==argv[i]) {
+            topk = atof(argv[++i]); continue;
+        }
+        if (string("-k")==argv[i]) {
+            topk = atof(argv[++i]); continue;
+        }
+        if (string("-topk_verify")==argv[i]) {
+            topk_verify = atoi(argv[++i]); continue;
+        }
+        if (string("-kv")==argv[i]) {
+            topk_verify = atoi(argv[++i]); continue;
+        }
+        if (string("-reorder")==argv[i]) {
+            reorder = atoi(argv[++i]); continue;
+        }
+        if (string("-r")==argv[i]) {
+            reorder = atoi(argv[++i]); continue;
+        }
+        if (string("-seed")==argv[i]) {
+            seed = atoi(argv[++i]); continue;
+        }
+        if (string("-sd")==argv[i]) {
+            seed = atoi(argv[++i]); continue;
+        }
+        if (string("-prune")==argv[i]) {
+            prune = atoi(argv[++i]); continue;
+        }
+        if (string("-pr")==argv[i]) {
+            prune = atoi(argv[++i]); continue;
+        }
+        if (string("-bipartite")==argv[i]) {
+            bipartite = atoi(argv[++i]); continue;
+        }
+        if (string("-bp")==argv[i]) {
+            bipartite = atoi(argv[++i]); continue;
+        }
+        if (string("-stats")==argv[i]) {
+            stats = atoi(argv[++i]); continue;
+        }
+        if (string("-js")==argv[i]) {
+            stats = atoi(argv[++i]); continue;
+        }
+        if (string("-max_mem")==argv[i]) {
+            max_mem = atof(argv[++i]); continue;
+        }
+        if (string("-mm")==argv[i]) {
+            max_mem = atof(argv[++i]); continue;
+        }
+        if (string("-serve")==argv[i]) {
+            serve = string(argv[++i]); continue;
+        }
+        if (string("-sv")==argv[i]) {
+            serve = string(argv[++i]); continue;
+        }
+        if (string("-workers")==argv[i]) {
+            workers = atoi(argv[++i]); continue;
+        }
+        if (string("-wk")==argv[i]) {
+            workers = atoi(argv[++i]); continue;
+        }
+        if (string("-accuracy")==argv[i]) {
+            accuracy = atof(argv[++i]); continue;
+        }
+        if (string("-ac")==argv[i]) {
+            accuracy = atof(argv[++i]); continue;
+        }
 
         unrecognizedOptionError(argv[i++]);
     }
@@ -191,11 +362,14 @@ print_help()
 
     /* */
     cerr << endl << "Method: " << endl << endl;
+    cerr << setw(W) << "0. " << "Automatic, the fastest method of the required -accuracy" << endl;
     cerr << setw(W) << "1. " << COMPLEMENTARYGOBLINEXACTBMATCH << endl;
     cerr << setw(W) << "2. " << GOBLINEXACTBMATCH << endl;
     cerr << setw(W) << "3. " << GREEDYAPPROXBMATCH << endl;
     cerr << setw(W) << "4. " << RECURSIVEGREEDYAPPROXBMATCH << endl;
     cerr << setw(W) << "5. " << BELIEFPROPBMATCH << endl;
+    cerr << setw(W) << "6. " << BSUITORAPPROXBMATCH << endl;
+    cerr << setw(W) << "7. " << BIPARTITEFLOWBMATCH << endl;
 
     cerr << "           " << endl;
     cerr << " Example 4:" << endl;
@@ -244,9 +418,20 @@ print_help()
     cerr << "symmetric.  For BP, the output weight is 0.5 * sum_{i,j} Wij Yij." << endl << endl;
 
     cerr << setw(W) << " ";
-    cerr << "The lower bounds are ignored by methods 3-5. Bipartite relaxation" << endl;
+    cerr << "The lower bounds are ignored by methods 5-6. Bipartite relaxation" << endl;
+    cerr << setw(W) << " ";
+    cerr << "assumes that the degree upper bounds can be met with equality." << endl;
+    cerr << setw(W) << " ";
+    cerr << "Methods 3-4 fill the nodes below their lower bounds after the greedy" << endl;
+    cerr << setw(W) << " ";
+    cerr << "pass, and report the total deficit if some bounds are still not met." << endl << endl;
+
+    cerr << setw(W) << " ";
+    cerr << "Every b-matching is verified against the degree bounds and the graph," << endl;
+    cerr << setw(W) << " ";
+    cerr << "with an LP upper bound on the weight (-v 1).  The exit status is 0 for" << endl;
     cerr << setw(W) << " ";
-    cerr << "assumes that the degree upper bounds can be met with equality." << endl << endl;
+    cerr << "a verified b-matching, 1 if the method failed, 2 if it has violations." << endl << endl;
     /*
     cerr << setw(W) << " ";
     cerr << "The reduction of method 2 may not always yield the optimal matching," << endl;
@@ -275,11 +460,33 @@ print()
     cerr << setw(W)  << "-w -weights ["  << left << setw(Warg) << weights << right << "] input file, NULL => std. input" << endl;
     cerr << setw(W)  << "-d -degrees ["  << left << setw(Warg) << degrees << right << "] input file, NULL => std. input" << endl;
     cerr << setw(W)  << "-o -output  ["  << left << setw(Warg) << output  << right << "] output file, NULL => std. output" << endl;
+    cerr << setw(W)  << "-p -profile ["  << left << setw(Warg) << profile << right << "] JSON solve profile file, NULL => none" << endl;
     cerr << setw(W)  << "-l -const_l ["  << left << setw(Warg) << const_l << right << "] positive integer, negative => std. input" << endl;
     cerr << setw(W)  << "-u -const_u ["  << left << setw(Warg) << const_u << right << "] positive integer, negative => std. input" << endl;
     cerr << setw(W)  << "-s -sparse  ["  << left << setw(Warg) << sparse  << right << "] 0 => matrix, 1 => IJW input format" << endl;
     cerr << setw(W)  << "-m -method  ["  << left << setw(Warg) << method  << right << "] selects algorithm" << endl;
     cerr << setw(W)  << "-v -verbose ["  << left << setw(Warg) << verbose << right << "] positive integer" << endl;
+    cerr << setw(W)  << "-q -queue   ["  << left << setw(Warg) << queue   << right << "] goblin heap: 0 => basic, 1 => binary, 2 => fibonacci," << endl;
+    cerr << setw(W)  << " "              << left << setw(Warg) << " "     << right << "  -1 => auto, -2 => benchmark all (methods 1-2)" << endl;
+    cerr << setw(W)  << "-pd -primal_dual [" << left << setw(Warg) << primal_dual << right << "] goblin methPrimalDual, negative => default" << endl;
+    cerr << setw(W)  << "-t -threads ["  << left << setw(Warg) << threads << right << "] threads of method 6, 0 => one per processor" << endl;
+    cerr << setw(W)  << "-im -improve ["  << left << setw(Warg) << improve << right << "] augment by paths/cycles of at most this many edges, 0 => none" << endl;
+    cerr << setw(W)  << "-e -eps     ["  << left << setw(Warg) << eps     << right << "] stop augmenting when a pass gains at most eps * wgt" << endl;
+    cerr << setw(W)  << "-tl -time_limit [" << left << setw(Warg) << time_limit << right << "] stop augmenting after this many seconds, 0 => none" << endl;
+    cerr << setw(W)  << "-in -initial ["  << left << setw(Warg) << initial << right << "] IJW b-matching file to improve instead of solving, NULL => none" << endl;
+    cerr << setw(W)  << "-st -stream ["  << left << setw(Warg) << stream  << right << "] 1 => semi-streaming b-matching of IJW input, in one pass" << endl;
+    cerr << setw(W)  << "-se -stream_eps [" << left << setw(Warg) << stream_eps << right << "] weight classes of -stream grow by 1+stream_eps" << endl;
+    cerr << setw(W)  << "-k -topk    ["  << left << setw(Warg) << topk    << right << "] keep the ceil(topk * u_i) heaviest edges of each node i, 0 => all" << endl;
+    cerr << setw(W)  << "-kv -topk_verify [" << left << setw(Warg) << topk_verify << right << "] 1 => compare with the exact b-matching of the kept edges" << endl;
+    cerr << setw(W)  << "-r -reorder ["  << left << setw(Warg) << reorder << right << "] relabel nodes: 1 => by degree, 2 => BFS, 3 => RCM, 0 => none" << endl;
+    cerr << setw(W)  << "-sd -seed   ["  << left << setw(Warg) << seed    << right << "] break ties between equal weights by a permutation drawn from seed, 0 => by index" << endl;
+    cerr << setw(W)  << "-pr -prune  ["  << left << setw(Warg) << prune   << right << "] 1 => drop edges of no optimal b-matching before method 1" << endl;
+    cerr << setw(W)  << "-bp -bipartite [" << left << setw(Warg) << bipartite << right << "] left nodes of method 7 are 0..bipartite-1, negative => 2-colouring" << endl;
+    cerr << setw(W)  << "-js -stats  ["  << left << setw(Warg) << stats   << right << "] 1 => write the solve profile and phase times as JSON to std. error" << endl;
+    cerr << setw(W)  << "-mm -max_mem ["  << left << setw(Warg) << max_mem << right << "] memory budget (MB), over it fall back to method 6 (3 if lower bounds) and top-k, 0 => none" << endl;
+    cerr << setw(W)  << "-sv -serve  ["  << left << setw(Warg) << serve   << right << "] serve requests on this Unix domain socket, NULL => none" << endl;
+    cerr << setw(W)  << "-wk -workers [" << left << setw(Warg) << workers << right << "] worker threads of -serve, 0 => one per processor" << endl;
+    cerr << setw(W)  << "-ac -accuracy [" << left << setw(Warg) << accuracy << right << "] guaranteed fraction of the max. weight for method 0, 1 => exact" << endl;
 
     cerr.unsetf(ios::right);
 }
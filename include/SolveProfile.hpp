@@ -0,0 +1,99 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _SOLVE_PROFILE_H_
+#define _SOLVE_PROFILE_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+#include "Vector.hpp"
+
+
+/* wall-clock time in seconds, with microsecond resolution */
+double wall_clock();
+
+/* peak resident set size of the process in megabytes, 0 if unknown */
+double peak_rss_mb();
+
+/* stream of the diagnostics of the solvers on the calling thread: cerr,
+ * unless set_solver_log gave the thread another (NULL => cerr again), as
+ * the threads of the MEX pool do to collect those of each problem */
+ostream & solver_log();
+void set_solver_log(ostream * log_ptr);
+
+
+/*
+ * per-solve profile: accumulated wall-clock time of named phases, the
+ * peak resident set size of the process at the end of each phase, named
+ * counters, and (optionally) the goblin internal timers
+ *
+ * phases with the same name accumulate, so that the nested
+ * solve_bmatching_problem calls of derived solvers add up
+ * */
+class SolveProfile
+{
+    public:
+        SolveProfile() : goblin_timers(0) { clear(); };
+
+        /* forget all phases, counters and timers */
+        void clear();
+
+        /* start / stop the clock of a named phase */
+        void start(const string & phase);
+        void stop(const string & phase);
+
+        /* accumulated time of a named phase, 0 if never started */
+        double phase_time(const string & phase) const;
+
+        /* add val to a named counter */
+        void count(const string & name, const double & val);
+
+        /* record a goblin internal timer (msec) */
+        void goblin_timer(const string & name, const double & msec);
+
+        /* write phases and counters as "prefix name = value" lines */
+        void write_summary(ostream & out, const string & prefix = "") const;
+
+        /* write profile as a JSON object */
+        void write_json(ostream & out) const;
+
+        /* collect the goblin internal timers when non-zero */
+        int goblin_timers;
+
+        /* phases */
+        vector<string>  phase_name_vec;
+        DoubleVec       phase_sec_vec;
+        DoubleVec       phase_start_vec;
+        DoubleVec       phase_rss_vec;
+
+        /* counters */
+        vector<string>  counter_name_vec;
+        DoubleVec       counter_val_vec;
+
+        /* goblin timers */
+        vector<string>  goblin_name_vec;
+        DoubleVec       goblin_msec_vec;
+
+        /* diagnostics of the solve, when the caller collected them with
+         * set_solver_log, written as "log" in the JSON if not empty */
+        string          log_str;
+
+    private:
+        /* index of name in name_vec, appending it if necessary */
+        static int lookup(vector<string> & name_vec, DoubleVec & val_vec, const string & name);
+};
+
+
+/* write string as a quoted JSON string */
+void write_json_string(ostream & out, const string & str);
+
+/* write summary of a solve and its profile as a JSON object, with the
+ * phases and counters of the whole run under "run" when run_profile is
+ * given */
+void write_solve_json(ostream & out, const string & method_str, const int & num_node, const int & num_ijw, const int & num_bmatch_edge, const double & bmatch_wgt, const int & success, const double & total_sec, const SolveProfile & profile, const SolveProfile * run_profile = NULL);
+
+
+#endif
@@ -233,6 +233,65 @@ void ijw_nnz(int & num_ijw, DoubleVec & ijw_vec);
 /* transpose ijw array */
 void ijw_transpose(int & num_ijw, DoubleVec & ijw_vec);
 
+/* read-only view of an ijw array, entry k being (i(k), j(k), w(k)): either
+ * a row-major DoubleVec, the three columns of a column-major num_ijw x 3
+ * matrix, e.g. a MATLAB array read in place, or three columns of doubles
+ * stride apart, e.g. a strided numpy array */
+class IjwView
+{
+    public:
+        IjwView(const DoubleVec & ijw_vec) : i_ptr(ijw_vec.empty() ? NULL : &ijw_vec[0]), j_ptr(i_ptr + (i_ptr ? 1 : 0)), w_ptr(i_ptr + (i_ptr ? 2 : 0)), stride(3) {};
+
+        IjwView(const double * col_ptr, const int & num_ijw) : i_ptr(col_ptr), j_ptr(col_ptr + num_ijw), w_ptr(col_ptr + 2*num_ijw), stride(1) {};
+
+        IjwView(const double * in_i_ptr, const double * in_j_ptr, const double * in_w_ptr, const int & in_stride) : i_ptr(in_i_ptr), j_ptr(in_j_ptr), w_ptr(in_w_ptr), stride(in_stride) {};
+
+        double i(const int & k) const { return i_ptr[stride*k]; };
+        double j(const int & k) const { return j_ptr[stride*k]; };
+        double w(const int & k) const { return w_ptr[stride*k]; };
+
+        /* row-major copy of the num_ijw entries */
+        void copy(const int & num_ijw, DoubleVec & ijw_vec) const;
+
+    private:
+        const double * i_ptr;
+        const double * j_ptr;
+        const double * w_ptr;
+        int stride;
+};
+
+/* keep only upper triangle entries between nodes marked in keep_vec, adding
+ * duplicates and dropping zeros, in (i,j) order */
+void ijw_keep_upper_tri(int & num_ijw, DoubleVec & ijw_vec, const vector<bool> & keep_vec);
+
+/* the same, into out_ijw_vec, reading the input through a view */
+void ijw_keep_upper_tri(const IjwView & ijw_view, const int & num_ijw, const vector<bool> & keep_vec, int & out_num_ijw, DoubleVec & out_ijw_vec);
+
+/* weight of entry (i,j) of an ijw array in (i,j) order, 0 if missing */
+double ijw_sorted_weight(const int & num_ijw, const DoubleVec & ijw_vec, const int & i, const int & j);
+
+/* entries of A (in (i,j) order) that are not entries of B, with weight 1 */
+void ijw_logical_difference(const int & num_a_ijw, const DoubleVec & a_ijw_vec, const int & num_b_ijw, const DoubleVec & b_ijw_vec, int & num_ijw, DoubleVec & ijw_vec);
+
+/* keep only entries among the k_vec[i] heaviest of node i or the k_vec[j] 
+ * heaviest of node j */
+void ijw_keep_topk(int & num_ijw, DoubleVec & ijw_vec, const int & num_node, const vector<int> & k_vec);
+
+/* order of the nodes, order_vec[new] = old: 1 => by decreasing degree, 
+ * 2 => breadth-first (Cuthill-McKee), 3 => reverse Cuthill-McKee */
+void ijw_node_order(const int & num_node, const int & num_ijw, const DoubleVec & ijw_vec, const int & method, vector<int> & order_vec);
+
+/* relabel the nodes, i => label_vec[i], in (i,j) order, keeping the 
+ * entries in the upper triangle if is_upper_tri */
+void ijw_relabel(const int & num_ijw, DoubleVec & ijw_vec, const vector<int> & label_vec, const int & is_upper_tri);
+
+/* bandwidth, max |i-j| */
+int ijw_bandwidth(const int & num_ijw, const DoubleVec & ijw_vec);
+
+/* rank_vec[k] of 0..num-1: k if seed is 0, otherwise a permutation drawn 
+ * from seed, the same on every platform */
+void seeded_rank(const int & num, const unsigned int & seed, vector<int> & rank_vec);
+
 
 
 #endif
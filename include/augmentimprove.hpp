@@ -0,0 +1,132 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _AUGMENT_IMPROVE_H_
+#define _AUGMENT_IMPROVE_H_
+
+#include <iostream>
+using namespace std;
+
+#include "method_names.hpp"
+#include "Vector.hpp"
+#include "SolveProfile.hpp"
+
+/* extensions of a walk between checks of the time limit */
+#define AUGMENT_CLOCK_STEPS (1024)
+
+
+/*
+ * post-optimization of a b-matching by short augmentations
+ *
+ * an augmentation is an alternating path or cycle of at most max_len
+ * edges, adding the unmatched edges and removing the matched ones; it
+ * applies if its weight gain is positive and its end nodes stay within
+ * their bounds.  Paths of 3 edges include the 2-opt swap of one edge for
+ * the matched edges at its end nodes, and cycles of 4 edges the exchange
+ * of two matched edges for two unmatched ones
+ *
+ * every pass applies the best augmentation found from each node in turn;
+ * passes repeat until a pass gains at most eps times the weight, or the
+ * time limit is reached
+ *
+ * a degree is never lowered below its lower bound, nor further below it
+ * if it started there; self-loops of the initial matching are kept, and
+ * no others are added
+ * */
+class AugmentImproveBmatch
+{
+
+    public:
+        AugmentImproveBmatch() : max_len(3), eps(0.0), time_limit(0.0)
+        {
+            description_str = string(AUGMENTIMPROVEBMATCH);
+        }
+
+        virtual ~AugmentImproveBmatch() { };
+
+        virtual string description();
+
+        /*
+         * improve the b-matching bmatch_edge_vec of the problem, in place
+         *
+         * bmatch_edge_vec may be any set of edges, e.g. the non-symmetric
+         * output of belief propagation: missing edges are dropped, and the
+         * lightest edges of nodes over their upper bounds; the output is
+         * an upper triangle in (i,j) order, and bmatch_wgt its weight
+         *
+         * returns success (1) or failure (0)
+         * */
+        virtual int improve_bmatching(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* maximum number of edges of an augmentation, 0 => no augmentation */
+        int max_len;
+
+        /* stop when a pass gains at most eps times the weight */
+        double eps;
+
+        /* stop after time_limit seconds, non-positive => no limit */
+        double time_limit;
+
+        /* description string */
+        string description_str;
+
+        /* wall-clock phases and counters, see SolveProfile */
+        SolveProfile profile;
+
+
+    private:
+
+        /* find the best augmentation from node s, into best_path_vec */
+        void search(const int & s);
+
+        /* extend the alternating walk of path_vec from node x */
+        void extend(const int & s, const int & x, const int & add, const double & gain);
+
+        /* true if the degrees of the end nodes of a walk stay within bounds */
+        bool is_feasible(const int & s, const int & x, const int & add) const;
+
+        /* toggle the edges of best_path_vec */
+        void apply();
+
+
+        /* num nodes */
+        int num_node;
+
+        /* edges (u<=v) and their weights */
+        vector<int> edge_u_vec;
+        vector<int> edge_v_vec;
+        DoubleVec   edge_wgt_vec;
+
+        /* edges of node u, heaviest first, without self-loops, are
+         * row_edge_vec[row_begin_vec[u] .. row_begin_vec[u+1]-1] */
+        vector<int> row_begin_vec;
+        vector<int> row_edge_vec;
+
+        /* node bounds and degrees */
+        vector<int> lb_vec;
+        vector<int> ub_vec;
+        vector<int> deg_vec;
+
+        /* matched edges */
+        vector<char> match_vec;
+
+        /* heaviest edge */
+        double max_wgt;
+
+        /* current walk, and the best augmentation found */
+        vector<int> path_vec;
+        vector<int> best_path_vec;
+        double      best_gain;
+
+        /* start of the passes, and whether time_limit was reached, checked
+         * every AUGMENT_CLOCK_STEPS extensions of a walk */
+        double      time0;
+        bool        is_timeout;
+        int         num_step;
+
+};
+
+
+#endif
+
@@ -0,0 +1,72 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _AUTOSELECT_H_
+#define _AUTOSELECT_H_
+
+#include <iostream>
+using namespace std;
+#include "Vector.hpp"
+
+
+/* features of a b-matching problem that the choice of a method looks at */
+class ProblemFeatures
+{
+    public:
+        /* nodes and entries of the ijw */
+        int num_node;
+        int num_ijw;
+
+        /* 2m / n(n-1), the bipartite graph of a full matrix being ~0.5 */
+        double density;
+
+        /* nodes with an edge and a positive upper bound, and the sum, mean
+         * and max of their bounds min(u_i, deg_i) */
+        int num_active;
+        double sum_ub;
+        double mean_ub;
+        double max_ub;
+
+        /* non-zero if some lower bound is positive */
+        int has_lower_bound;
+
+        /* non-zero if the edges between nodes of positive upper bound are
+         * 2-colourable (no self-loop, no odd cycle) */
+        int is_bipartite;
+};
+
+
+/* features of the problem of an ijw, in any order, with duplicates */
+void problem_features(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, ProblemFeatures & F);
+
+
+/* capability of a method: the guaranteed fraction of the maximum weight,
+ * 1 => exact, 0 => none (BP, and the mincost method 2, whose objective
+ * differs); and whether it needs a bipartite graph, or may not meet the
+ * lower bounds (all but the exact methods 1 and 7) */
+double method_accuracy(const int & method);
+int method_needs_bipartite(const int & method);
+int method_ignores_lower_bound(const int & method);
+
+
+/* estimated solve time (sec.) of a method, from a cost model calibrated
+ * with bmatch_bench, with num_thread threads for method 6 */
+double method_cost_estimate(const int & method, const ProblemFeatures & F, const int & num_thread);
+
+
+/*
+ * method 0 (auto): the fastest of the methods that meet the accuracy (the
+ * guaranteed fraction of the maximum weight, 1 => exact), can solve the
+ * problem (bipartiteness, lower bounds), and fit in max_mem MB (0 => no
+ * budget); if none fits, the fastest of the others, or method 1 if the
+ * accuracy is met by none
+ *
+ * the features, and why each method is taken or not, are written to
+ * log_ptr, if not NULL
+ * */
+int select_method(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, const double & accuracy, const double & max_mem, const int & num_thread, ostream * log_ptr);
+
+
+#endif
+
@@ -25,8 +25,13 @@ class BeliefPropBmatch : public AbstractBmatchSolver
         /* destructor */
         ~BeliefPropBmatch();
 
-        /* solve_bmatching_problem */
-        int solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+        /* solve_bmatching_view */
+        int solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* dense: the n x n weights, and n messages, potentials and
+         * neighbours for each of the 2n nodes, ~56 n^2 bytes whatever the
+         * number of entries of the full matrix */
+        double memory_estimate(const int & num_node, const int & num_ijw) const;
 
 };
 
@@ -60,8 +65,9 @@ void updateMessages(node_t *node, int b);
 /* checks if there is a valid bmatching in the beliefs */
 int permCheck(node_t **nodes, int**P, int n, int b);
 
-/* solve */
-int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int node_cap, double * output_edge_ptr, int verbose);
+/* solve, with the number of iterations and of message updates in
+ * num_iter and num_message, when not NULL */
+int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int node_cap, double * output_edge_ptr, int verbose, int * num_iter, double * num_message);
 
 
 } 
@@ -0,0 +1,129 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _BIPARTITE_BMATCH_H_
+#define _BIPARTITE_BMATCH_H_
+
+#include <iostream>
+using namespace std;
+
+#include "method_names.hpp"
+#include "BmatchSolver.hpp"
+#include "Vector.hpp"
+
+
+/*
+ * exact maxwgt b-matching of a bipartite graph, as a min-cost flow
+ *
+ * each left node u supplies ub_u units to a sink t, by arcs u->v of cost
+ * -w(u,v) and capacity 1 for the edges, then v->t for the right nodes, or
+ * by an arc u->t of cost 0 for the units it leaves unmatched; the arcs to
+ * t are split into a lower bound part, of capacity LB and a cost of -big
+ * (right) or big (left), big exceeding any path of the edges, and the
+ * rest, of capacity UB-LB and cost 0
+ *
+ * successive shortest paths from the left nodes in turn (Dijkstra on
+ * reduced costs, stopped at t, as in the Hungarian method) route all the
+ * supplies, so the b-matching of maximum weight among those meeting the
+ * most lower bounds is found without the blossoms of the general graph
+ * methods; if some lower bound is not met, the solve fails as for the
+ * exact methods
+ *
+ * a search only settles the nodes closer than t, most often a small part
+ * of the graph, but it may reach all of it: the worst case remains one
+ * O(m log n) search per unit of b, O(sum b m log n) in all
+ *
+ * the left nodes are those below num_left, or, if num_left is negative,
+ * one side of a 2-colouring of the graph; an edge within a side fails
+ * */
+class BipartiteFlowBmatch : public BmatchSolver
+{
+
+    public:
+        BipartiteFlowBmatch() : num_left(-1), verbose(0), num_node(0), num_ijw(0)
+        {
+            description_str = string(BIPARTITEFLOWBMATCH);
+        }
+
+        virtual ~BipartiteFlowBmatch();
+
+        /* memory estimate: the arcs of the flow network and their reverses */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
+
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* nodes below num_left are on the left, negative => 2-colouring */
+        int num_left;
+
+        /* sides of an upper triangle ijw between nodes marked in keep_vec,
+         * 0 => left, 1 => right, or an empty side_vec if an edge is within
+         * a side */
+        static void bipartition(const int & num_node, const int & num_left, const int & num_ijw, const DoubleVec & ijw_vec, const vector<bool> & keep_vec, vector<int> & side_vec);
+
+
+    private:
+
+        /* print memory */
+        virtual void print(const int & print_what);
+
+        /* initialize assuming 0-based indices, and an upper triangle ijw
+         * in (i,j) order without duplicates */
+        virtual void init(const int & in_verbose, const int& num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec);
+
+        /* solve */
+        virtual int solve();
+
+        /* copy b-matching solution
+         *  assuming  0-based indices */
+        virtual void solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec);
+
+
+        /* add the arc u->v and its reverse */
+        void add_arc(const int & u, const int & v, const int & cap, const double & cost);
+
+
+        /* print verbosity */
+        int verbose;
+
+        /* num nodes */
+        int num_node;
+
+        /* num ijw */
+        int num_ijw;
+
+        /* sides of the nodes, 0 => left, 1 => right */
+        vector<int> side_vec;
+
+        /* edges (u<=v) */
+        vector<int> edge_u_vec;
+        vector<int> edge_v_vec;
+
+        /* arc a of the network goes from arc_tail_vec[a] to arc_head_vec[a],
+         * and a^1 is its reverse; the arc of edge e is edge_arc_vec[e] */
+        vector<int> arc_tail_vec;
+        vector<int> arc_head_vec;
+        vector<int> arc_cap_vec;
+        DoubleVec   arc_cost_vec;
+        vector<int> edge_arc_vec;
+
+        /* arcs out of node x are row_arc_vec[row_begin_vec[x] .. row_begin_vec[x+1]-1] */
+        vector<int> row_begin_vec;
+        vector<int> row_arc_vec;
+
+        /* arcs whose capacity left is the deficit of a lower bound: the
+         * lower bound arcs of the right nodes, and the reverses of those
+         * of the left nodes */
+        vector<int> lb_arc_vec;
+
+        /* units of the left nodes not yet routed to t */
+        vector<int> supply_vec;
+
+        /* b-matching, in edge order */
+        vector<int> B_match;
+
+};
+
+
+#endif
+
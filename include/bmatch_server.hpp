@@ -0,0 +1,146 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _BMATCH_SERVER_H_
+#define _BMATCH_SERVER_H_
+
+#include <string>
+#include <deque>
+#include <set>
+#include <pthread.h>
+using namespace std;
+#include "Vector.hpp"
+#include "Parameter.hpp"
+#include "AbstractBmatchSolver.hpp"
+
+/* number of methods served */
+#define SERVER_NUM_METHOD (7)
+
+/* largest request, and the memory budget (MB) of a request without
+ * -max_mem, so that a bad header can not exhaust the memory */
+#define SERVER_MAX_NODE (1<<28)
+#define SERVER_MAX_IJW (1<<28)
+#define SERVER_MAX_MEM (4096.0)
+
+/* bytes read from a connection at a time */
+#define SERVER_BUFFER_SIZE (65536)
+
+
+/* a client connection, read through a buffer */
+class ServerConn
+{
+    public:
+        ServerConn(const int & in_fd) : fd(in_fd), buf_vec(SERVER_BUFFER_SIZE), begin(0), end(0) {};
+
+        /* next line, without its newline; returns 0 at the end */
+        int read_line(string & line);
+
+        /* num numbers as text, separated by white space; returns 0 if one
+         * is missing or malformed */
+        int read_text(const int & num, DoubleVec & val_vec);
+
+        /* num native doubles; returns 0 if they are cut short */
+        int read_binary(const int & num, DoubleVec & val_vec);
+
+        /* write len bytes; returns 0 if the client went away */
+        int write_all(const char * ptr, const size_t & len);
+
+        /* socket */
+        int fd;
+
+    private:
+        /* refill the buffer; returns 0 at the end */
+        int fill();
+
+        /* unread bytes are buf_vec[begin .. end-1] */
+        vector<char> buf_vec;
+        size_t begin;
+        size_t end;
+};
+
+
+/*
+ * b-matching server on a Unix domain socket
+ *
+ * a thread accepts the connections and queues them for a pool of worker
+ * threads; a worker serves the requests of a connection one after
+ * another, until the client closes it, with solver instances that it
+ * keeps warm between requests, one per method
+ *
+ * requests are a line of text,
+ *
+ *   solve <method> <format> <num_node> <num_ijw>
+ *       followed by num_ijw edges "i j w" (0-based nodes) and num_node
+ *       degree bounds "l u", as text (format ijw) or as native doubles
+ *       (format binary: 3 per edge and 2 per node, as bmatch_gen -f binary),
+ *       method 0 being the fastest method of -accuracy for the problem
+ *   ping
+ *   shutdown
+ *
+ * answered by
+ *
+ *   ok <success> <num_bmatch_edge> <wgt> <sec>
+ *       followed by the edges of the b-matching, in the format of the
+ *       request, and sec the solve time
+ *   pong
+ *   ok                         (and the server stops)
+ *   error <message>            (and the connection is closed)
+ *
+ * a request is refused, before its edges are read, if its memory estimate
+ * is over -max_mem, or SERVER_MAX_MEM without it
+ * */
+class BmatchServer
+{
+    public:
+        BmatchServer(const Parameter & in_PP);
+
+        ~BmatchServer();
+
+        /* listen on PP.serve, and serve until a shutdown request;
+         * returns 0 on success, 1 if the socket can not be set up */
+        int run();
+
+    private:
+
+        /* worker thread entry point */
+        static void * run_worker(void * arg);
+
+        /* take connections from the queue until the server stops */
+        void work();
+
+        /* serve the requests of a connection */
+        void serve(ServerConn & conn, vector<AbstractBmatchSolver *> & solver_vec);
+
+        /* answer a solve request; returns 0 with error_str set if the
+         * request is malformed or the client went away */
+        int solve(ServerConn & conn, const string & line, vector<AbstractBmatchSolver *> & solver_vec, string & error_str);
+
+        /* stop accepting, and end the connections being served */
+        void stop();
+
+        /* parameters: methods, threads of method 6, workers, verbose */
+        Parameter PP;
+
+        /* listening socket */
+        int listen_fd;
+
+        /* non-zero once stopped */
+        int is_stopped;
+
+        /* accepted connections waiting for a worker, and those served */
+        deque<int> conn_queue;
+        set<int> active_set;
+
+        /* guards is_stopped, conn_queue, active_set and cerr */
+        pthread_mutex_t lock;
+        pthread_cond_t cond;
+};
+
+
+/* serve b-matching requests on the socket PP.serve, see BmatchServer */
+int serve_bmatch(const Parameter & PP);
+
+
+#endif
+
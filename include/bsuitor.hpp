@@ -0,0 +1,138 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _BSUITOR_SOLVER_H_
+#define _BSUITOR_SOLVER_H_
+
+#include <iostream>
+#include <pthread.h>
+using namespace std;
+
+#include "method_names.hpp"
+#include "BmatchSolver.hpp"
+#include "Vector.hpp"
+
+/* node locks are striped over this many mutexes */
+#define BSUITOR_NUM_LOCK (4096)
+
+/* nodes taken from the queue by a thread at a time */
+#define BSUITOR_CHUNK (256)
+
+
+/*
+ * b-suitor: parallel locally dominant edge 1/2 approximation
+ *
+ * every node proposes to its heaviest nbrs, in turn, until it holds
+ * b proposals; a node keeps the b heaviest proposals it receives in a heap
+ * and displaces the lightest one, whose proposer then proposes again;
+ * threads process the nodes concurrently, locking the heap of a node
+ *
+ * edges are ordered by weight and then by rank (see seed), so the matching
+ * is the unique locally dominant b-matching and does not depend on the
+ * threads; self-loops and lower bounds are ignored
+ * */
+class BSuitorApproxBmatch : public BmatchSolver
+{
+
+    public:
+        BSuitorApproxBmatch();
+
+        virtual ~BSuitorApproxBmatch();
+
+        /* memory estimate: the edge arrays, adjacency and suitor heaps */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
+
+        /* number of threads, non-positive => number of processors */
+        int num_thread;
+
+        /* number of threads used for num_thread */
+        static int select_num_thread(const int & num_thread);
+
+
+    private:
+
+        /* print memory */
+        virtual void print(const int & print_what);
+
+        /* initialize assuming 0-based indices, and an upper triangle ijw
+         * in (i,j) order without duplicates */
+        virtual void init(const int & in_verbose, const int& num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec);
+
+        /* solve */
+        virtual int solve();
+
+        /* copy b-matching approx solution
+         *  assuming  0-based indices */
+        virtual void solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec);
+
+
+        /* run work() on the nodes of queue_vec with num_thread threads */
+        void run_threads(const int & phase);
+
+        /* thread entry point */
+        static void * run_thread(void * arg);
+
+        /* process the nodes of queue_vec until it is exhausted */
+        void work(const int & phase, vector<int> & displaced_vec);
+
+        /* u proposes until it holds bcap_vec[u] proposals or has no nbrs left */
+        void propose(const int & u, vector<int> & displaced_vec);
+
+
+        /* print verbosity */
+        int verbose;
+
+        /* num nodes */
+        int num_node;
+
+        /* num ijw */
+        int num_ijw;
+
+        /* edges (u<=v) and their weights */
+        vector<int> edge_u_vec;
+        vector<int> edge_v_vec;
+        DoubleVec   edge_wgt_vec;
+
+        /* rank of the edges among equal weights, the lowest first */
+        vector<int> edge_rank_vec;
+
+        /* edges of node u, heaviest first, are
+         * row_edge_vec[row_begin_vec[u] .. row_begin_vec[u+1]-1] */
+        vector<int> row_begin_vec;
+        vector<int> row_edge_vec;
+
+        /* next edge of each node to propose along */
+        vector<int> row_next_vec;
+
+        /* vector of node capacities */
+        vector<int> bcap_vec;
+
+        /* vector of proposals held by each node's suitors */
+        vector<int> count_vec;
+
+        /* heap of the proposals received by node u, lightest on top, is
+         * heap_edge_vec[heap_begin_vec[u] .. heap_begin_vec[u]+heap_size_vec[u]-1] */
+        vector<int> heap_begin_vec;
+        vector<int> heap_size_vec;
+        vector<int> heap_edge_vec;
+
+        /* striped node locks */
+        pthread_mutex_t node_lock_arr[BSUITOR_NUM_LOCK];
+
+        /* nodes to process, and the next one to hand out */
+        vector<int> queue_vec;
+        int queue_next;
+        pthread_mutex_t queue_lock;
+
+        /* nodes displaced during a round */
+        vector<int> displaced_vec;
+
+        /* b-matching, in edge order */
+        vector<int> B_match;
+
+};
+
+
+#endif
+
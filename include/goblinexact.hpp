@@ -12,20 +12,40 @@
 
 #define GOBLIN_COST_SCALE (100.0)
 
-
-/* */
+/* values of goblinController::methPQ */
+#define GOBLIN_PQ_AUTO      (-1)
+#define GOBLIN_PQ_BASIC     (0)
+#define GOBLIN_PQ_BINARY    (1)
+#define GOBLIN_PQ_FIBONACCI (2)
+
+/* graphs with fewer nodes use the linear-scan basic heap (an unmeasured
+ * default, see bmatch -queue -2) */
+#define GOBLIN_PQ_BASIC_MAX_NODE (128)
+
+
+/* 
+ * each instance owns its goblin controller, graph and capacity buffers, 
+ * and separate instances may be used on separate threads; as goblin keeps
+ * global state, their goblin solves are serialized by a process-wide lock
+ * (the preprocessing and the weights run concurrently); a single instance
+ * is not shared between threads
+ * */
 class GoblinExactBmatch : public BmatchSolver 
 {
 
     public:
-        GoblinExactBmatch() 
+        GoblinExactBmatch() : meth_pq(GOBLIN_PQ_AUTO), meth_primal_dual(-1), gptr(NULL), context(NULL)
         {
             description_str = string(GOBLINEXACTBMATCH);
         }
 
         virtual ~GoblinExactBmatch();
 
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+        /* memory estimate: the ijw copies and the goblin graph, whose
+         * matching solver adds a balanced flow network of its own */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
+
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
 
         /* scale_weight */
         virtual void scale_weight(const int & num_ijw, DoubleVec & ijw_vec, const double & min1, const double & max1);
@@ -38,6 +58,18 @@ class GoblinExactBmatch : public BmatchSolver
         /* scale_weight3 */
         virtual void scale_weight3(const int & num_ijw, DoubleVec & ijw_vec, const double & ff);
 
+        /* true if all weights are integers whose absolute sum is at most max1 */
+        static bool is_integral_weight(const int & num_ijw, const DoubleVec & ijw_vec, const double & max1);
+
+        /* priority queue used inside MinCMatching, see GOBLIN_PQ_* */
+        int meth_pq;
+
+        /* goblin methPrimalDual, negative => goblin default */
+        int meth_primal_dual;
+
+        /* priority queue selected for a graph, resolving GOBLIN_PQ_AUTO */
+        static int select_pq(const int & meth_pq, const int & num_node);
+
 
 
     private:
@@ -69,9 +101,15 @@ class GoblinExactBmatch : public BmatchSolver
         //graph*  gptr;
         abstractGraph*  gptr;
 
+        /* per-instance goblin controller of gptr */
+        goblinController* context;
+
         /* vectors of node lower and upper capacities */
-        TCap*   LB_TCap_vec;
-        TCap*   UB_TCap_vec;
+        vector<TCap>    LB_TCap_vec;
+        vector<TCap>    UB_TCap_vec;
+
+        /* release gptr and context */
+        void release();
 
 };
 
@@ -81,21 +119,52 @@ class ComplementaryGoblinExactBmatch : public GoblinExactBmatch
 {
 
     public:
-        ComplementaryGoblinExactBmatch() 
+        ComplementaryGoblinExactBmatch() : prune(0)
         {
             description_str = string(COMPLEMENTARYGOBLINEXACTBMATCH);
         }
 
         virtual ~ComplementaryGoblinExactBmatch();
 
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+        /* memory estimate: as the mincost method, with the complement */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
+
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* 
+         * drop the edges of an upper triangle ijw in (i,j) order without 
+         * duplicates that are in no maxwgt b-matching, for the upper bounds 
+         * ub_vec (at most the degrees, self-loops=2) and no lower bounds
+         *
+         * for a node x, let m_x(e) be the weight of the heaviest edge of x 
+         * other than e, or 0 if x can never be full (ub_x = degree of x); 
+         * then (u,v), u!=v, is dropped if u has ub_u nbrs x, other than v, 
+         * with ub_x > 0 and w(u,x) - m_x((u,x)) > w(u,v), or likewise for 
+         * v: one edge (u,x) is unmatched, and matching it instead of (u,v), 
+         * unmatching an edge of x if x is full, strictly increases the 
+         * weight
+         *
+         * returns the number of edges dropped
+         * */
+        static int prune_dominated_edges(const int & num_node, const vector<int> & ub_vec, int & num_ijw, DoubleVec & ijw_vec);
+
+        /* non-zero => drop the edges of no maxwgt b-matching before solving, 
+         * when there are no lower bounds */
+        int prune;
 
 
 };
 
 
-/* */
-class NegatedWeightsGoblinExactBmatch : public GoblinExactBmatch
+/* 
+ * retired negated-weights formulation, kept for source compatibility
+ *
+ * it used to solve the mincost problem with bounds [UB, deg] and weights 
+ * negated and squeezed into [1e-32, 1], which lost precision and gave goblin 
+ * a needlessly dense lower bound vector; it now uses the exact complementary 
+ * maxwgt formulation of method 1
+ * */
+class NegatedWeightsGoblinExactBmatch : public ComplementaryGoblinExactBmatch
 {
 
     public:
@@ -106,10 +175,6 @@ class NegatedWeightsGoblinExactBmatch : public GoblinExactBmatch
 
         virtual ~NegatedWeightsGoblinExactBmatch();
 
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
-
-
-
 };
 
 #endif
@@ -23,6 +23,8 @@ typedef hash_map_type::value_type   hash_entry_type;
 typedef pair<int, int>              NodePair;
 typedef vector<NodePair>            EdgeList;
 
+typedef vector<int>                 EdgeIndexList;
+
 
  
 /* */
@@ -30,7 +32,7 @@ class GreedyApproxBmatch : public BmatchSolver
 {
 
     public:
-        GreedyApproxBmatch() 
+        GreedyApproxBmatch() : report_deficit(1)
         {
             description_str = string(GREEDYAPPROXBMATCH);
         }
@@ -38,13 +40,17 @@ class GreedyApproxBmatch : public BmatchSolver
 
         virtual ~GreedyApproxBmatch();
 
+        /* memory estimate: the edge arrays and the adjacency */
+        virtual double memory_estimate(const int & num_node, const int & num_ijw) const;
+
 
-    private:
+    protected:
 
         /* print memory */
         virtual void print(const int & print_what);
 
-        /* initialize assuming 1-based indices */
+        /* initialize assuming 0-based indices, and an upper triangle ijw 
+         * in (i,j) order without duplicates */
         virtual void init(const int & in_verbose, const int& num_node, const DoubleVec & node_capacities_vec, const int & num_ijw, const DoubleVec & ijw_vec); 
 
         /* solve */
@@ -55,6 +61,28 @@ class GreedyApproxBmatch : public BmatchSolver
         virtual void solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec);
 
 
+        /* build the adjacency of an upper triangle ijw in (i,j) order 
+         * without duplicates, with all edges in the residual graph */
+        void build_graph(const int & in_num_node, const int & in_num_ijw, const DoubleVec & ijw_vec);
+
+        /* drop the edges that left the residual graph from the rows */
+        void compact_graph();
+
+        /* start a round on the residual edges between nodes marked in 
+         * keep_vec, with capacities from the upper degree bounds */
+        void start_round(const DoubleVec & deg_bdd_vec, const vector<bool> & keep_vec);
+
+        /* index of the live edge (u,v), or -1 */
+        int find_edge(const int & u, const int & v) const;
+
+        /* remove an edge from the graph of the current round */
+        void erase_edge(const int & e);
+
+        /* raise the matched degrees of B_match to the lower bounds of the 
+         * round, returning the total deficit left */
+        int repair_lower_bounds();
+
+
         /* print verbosity */
         int verbose;
 
@@ -64,23 +92,52 @@ class GreedyApproxBmatch : public BmatchSolver
         /* num ijw */
         int num_ijw;
 
-        /* adjacency lists */
-        SparseVecVec Amat;
+        /* adjacency rows: the nbrs of u, in increasing order, and their edges
+         * are row_nbr_vec and row_edge_vec over [row_begin_vec[u], row_end_vec[u]) */
+        vector<int> row_begin_vec;
+        vector<int> row_end_vec;
+        vector<int> row_nbr_vec;
+        vector<int> row_edge_vec;
+
+        /* edges (u<=v) and their weights */
+        vector<int> edge_u_vec;
+        vector<int> edge_v_vec;
+        DoubleVec   edge_wgt_vec;
+
+        /* rank of the edges among equal weights, the lowest first, see seed */
+        vector<int> edge_rank_vec;
+
+        /* edge is in the residual graph, i.e. not matched or pruned */
+        vector<char> edge_alive_vec;
 
-        /* edge weight lists */
-        SparseVecVec Wmat;
+        /* edge is in the graph walked by the current round */
+        vector<char> edge_live_vec;
+
+        /* vector of live nbrs per node (self-loops=1) */
+        LongIntVec nbr_cnt_vec;
 
         /* vector of node capacities */
         LongIntVec bcap_vec;
 
+        /* vectors of node lower and upper bounds of the round */
+        LongIntVec lb_vec;
+        LongIntVec ub_vec;
+
         /* vector of node degrees */
         LongIntVec deg_vec;
 
+        /* first node that may still start a walk */
+        int start_node;
+
+        /* deficit left by repair_lower_bounds, and whether solve reports it */
+        int lb_deficit;
+        int report_deficit;
+
         /* b-matchings */
-        EdgeList B_match;
+        EdgeIndexList B_match;
 
         /* b-matchings */
-        EdgeList M_walk;
+        EdgeIndexList M_walk;
 
 };
 
@@ -92,11 +149,14 @@ class RecursiveGreedyApproxBmatch : public GreedyApproxBmatch
         RecursiveGreedyApproxBmatch() 
         {
             description_str = string(RECURSIVEGREEDYAPPROXBMATCH);
+            report_deficit = 0;
         }
 
         virtual ~RecursiveGreedyApproxBmatch();
 
-        virtual int solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+        /* repeats the greedy method on the residual graph and degree bounds,
+         * in rounds over a single adjacency, until no edge is added */
+        virtual int solve_bmatching_view(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
 
 };
 
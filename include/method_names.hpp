@@ -6,13 +6,21 @@
 
 #define COMPLEMENTARYGOBLINEXACTBMATCH "exact maxwgt solution using goblin via subgraph complement"
 
-#define NEGATEDWEIGHTSGOBLINEXACTBMATCH "approximate maxwgt solution using goblin via negated weights"
+#define NEGATEDWEIGHTSGOBLINEXACTBMATCH "exact maxwgt solution using goblin (retired negated weights, via subgraph complement)"
 
 #define GREEDYAPPROXBMATCH "greedy 1/2 approximation to maxwgt solution"
 
 #define RECURSIVEGREEDYAPPROXBMATCH "greedy 1/2 approximation to maxwgt solution with recursion"
 
+#define BSUITORAPPROXBMATCH "parallel b-suitor 1/2 approximation to maxwgt solution"
+
+#define BIPARTITEFLOWBMATCH "exact maxwgt solution of a bipartite graph by min-cost flow"
+
 #define BELIEFPROPBMATCH "bipartite relaxation to maxwgt solution using belief propagation"
 
+#define STREAMBMATCH "semi-streaming weight-class approximation to maxwgt solution"
+
+#define AUGMENTIMPROVEBMATCH "improved by short augmentations"
+
 #endif
 
@@ -0,0 +1,25 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _NEW_SOLVER_H_
+#define _NEW_SOLVER_H_
+
+#include "Parameter.hpp"
+#include "AbstractBmatchSolver.hpp"
+
+
+/*
+ * solver of a method, set up by the solver options of PP: -prune, -queue
+ * and -primal_dual of the goblin methods 1-2, -threads of method 6 and
+ * -bipartite of method 7; NULL if the method is not recognized
+ *
+ * every front end (bmatch, the server, method 0, bmatch_bench, the MEX
+ * and python interfaces) makes its solvers here, so that an option means
+ * the same in each
+ * */
+AbstractBmatchSolver * new_solver(const int & method, const Parameter & PP);
+
+
+#endif
+
@@ -0,0 +1,96 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _STREAM_BMATCH_H_
+#define _STREAM_BMATCH_H_
+
+#include <iostream>
+#include <map>
+using namespace std;
+
+#include "method_names.hpp"
+#include "Vector.hpp"
+#include "SolveProfile.hpp"
+
+/* default width of the weight classes, (1+eps) */
+#define STREAM_EPS (0.1)
+
+
+/* maximal b-matching of the edges of one weight class */
+class StreamWeightClass
+{
+    public:
+        /* matched degree of the nodes of the class */
+        map<int,int> count_map;
+
+        /* matched edges, in arrival order */
+        vector<int> edge_u_vec;
+        vector<int> edge_v_vec;
+        DoubleVec   edge_wgt_vec;
+};
+
+
+/*
+ * semi-streaming b-matching, in one pass over IJW entries
+ *
+ * the weights are bucketed into classes [(1+eps)^k, (1+eps)^(k+1)), and
+ * each class keeps a maximal b-matching of its edges, in arrival order;
+ * at the end of the stream the classes are combined greedily, heaviest
+ * class first (the weight-class reduction of Crouch and Stubbs, a
+ * (4+eps)-approximation for matchings)
+ *
+ * memory is O(sum_i b_i) per non-empty class, independent of the number
+ * of entries; entries with i>j are skipped and duplicates are not added,
+ * and the lower bounds are ignored
+ * */
+class StreamBmatch
+{
+
+    public:
+        StreamBmatch() : eps(STREAM_EPS), const_ub(-1.0)
+        {
+            description_str = string(STREAMBMATCH);
+        }
+
+        virtual ~StreamBmatch() { };
+
+        virtual string description();
+
+        /*
+         * read IJW entries from in, until a blank line or the end of the
+         * stream, and b-match them
+         *
+         * num_node is the number of nodes seen, at least the number of
+         * rows of deg_bdd_vec, and num_entry the number of entries read
+         *
+         * returns success (1) or failure (0)
+         * */
+        virtual int solve_bmatching_stream(istream & in, const DoubleVec & deg_bdd_vec, int & num_node, double & num_entry, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose);
+
+        /* width of the weight classes */
+        double eps;
+
+        /* upper bound of the nodes beyond deg_bdd_vec, negative => none */
+        double const_ub;
+
+        /* description string */
+        string description_str;
+
+        /* wall-clock phases and counters, see SolveProfile */
+        SolveProfile profile;
+
+
+    private:
+
+        /* upper bound of node u, negative if unknown */
+        int upper_bound(const DoubleVec & deg_bdd_vec, const int & u) const;
+
+        /* weight classes, by exponent */
+        map<int,StreamWeightClass> class_map;
+
+};
+
+
+#endif
+
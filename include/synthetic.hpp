@@ -0,0 +1,180 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _SYNTHETIC_H_
+#define _SYNTHETIC_H_
+
+#include <string>
+using namespace std;
+#include "Vector.hpp"
+
+/* kinds of synthetic graphs */
+#define SYNTHETIC_RANDOM    (1)
+#define SYNTHETIC_POWERLAW  (2)
+#define SYNTHETIC_BLOCK     (3)
+#define SYNTHETIC_DENSE     (4)
+#define SYNTHETIC_BIPARTITE (5)
+#define SYNTHETIC_KNN       (6)
+#define SYNTHETIC_NUM_KIND  (6)
+
+/* distributions of the weights */
+#define SYNTHETIC_WGT_UNIFORM (1)
+#define SYNTHETIC_WGT_EXP     (2)
+#define SYNTHETIC_WGT_INT     (3)
+#define SYNTHETIC_WGT_CONST   (4)
+#define SYNTHETIC_WGT_DIST    (5)
+#define SYNTHETIC_WGT_NUM_KIND (5)
+
+/* expected edges of a chunk of rows */
+#define SYNTHETIC_CHUNK_EDGES (65536)
+
+
+/* 32-bit xorshift generator, as in seeded_rank, so that the graphs of a
+ * seed do not depend on the platform's rand() */
+class SyntheticRand
+{
+    public:
+        SyntheticRand(const unsigned int & seed) : x((seed!=0) ? seed : 2463534242u) {};
+
+        /* next 32 bits */
+        unsigned int next()
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            return x;
+        }
+
+        /* uniform in (0,1] */
+        double uniform()
+        {
+            return (double(next()) + 1.0)/4294967296.0;
+        }
+
+        /* uniform in 0..n-1 */
+        int below(const int & n)
+        {
+            return int(next() % (unsigned int)(n));
+        }
+
+    private:
+        unsigned int x;
+};
+
+
+/*
+ * synthetic graph of num_node nodes, drawn from seed, without self-loops
+ * or duplicate edges
+ *
+ *  random    : each edge with probability avg_deg/(num_node-1)
+ *              (Erdos-Renyi)
+ *  powerlaw  : edge (i,j) with probability min(1, w_i w_j / sum_k w_k),
+ *              w_i proportional to (1+i)^(-1/(gamma-1)), so that the
+ *              degrees follow a power law of exponent gamma and average
+ *              avg_deg (Chung-Lu)
+ *  block     : disjoint cliques of block_size consecutive nodes, as in
+ *              Example 2 of bmatch_ijw.m
+ *  dense     : all edges
+ *  bipartite : as random, between nodes below num_node/2 and the rest
+ *  knn       : points uniform in the unit square, each joined to its knn
+ *              nearest points
+ *
+ * the rows of the nodes are split into chunks of about
+ * SYNTHETIC_CHUNK_EDGES expected edges, each drawn from its own stream of
+ * seed, so that the chunks can be drawn concurrently, in any order, and
+ * the graph of a seed does not depend on the number of threads
+ * */
+class SyntheticGraph
+{
+
+    public:
+        SyntheticGraph() : kind(SYNTHETIC_RANDOM), num_node(0), avg_deg(8.0), gamma(2.5), block_size(9), knn(8), wgt_kind(SYNTHETIC_WGT_UNIFORM), max_wgt(1.0), seed(1), num_edge(0.0), prob(0.0), sum_wgt(0.0), num_grid(0) {};
+
+        /* set up the chunks, and the points or node weights, after the
+         * parameters are set; returns success (1) or failure (0) */
+        int init();
+
+        /* number of chunks */
+        int num_chunk() const
+        {
+            return int(chunk_begin_vec.size()) - 1;
+        }
+
+        /* edges of chunk c, as an ijw (i<j) in (i,j) order, except for
+         * knn; may be called concurrently once init has returned */
+        void chunk_ijw(const int & c, int & num_ijw, DoubleVec & ijw_vec) const;
+
+        /* expected number of edges, at most num_node*knn for knn */
+        double expected_edges() const
+        {
+            return num_edge;
+        }
+
+        /* parameters */
+        int kind;
+        int num_node;
+        double avg_deg;
+        double gamma;
+        int block_size;
+        int knn;
+        int wgt_kind;
+        double max_wgt;
+        unsigned int seed;
+
+
+    private:
+
+        /* weight of an edge of length dist */
+        double edge_wgt(SyntheticRand & rnd, const double & dist) const;
+
+        /* knn nearest points of point i, by distance and then index */
+        void nearest(const int & i, vector< pair<double,int> > & nbr_vec) const;
+
+        /* rows of chunk c are chunk_begin_vec[c] .. chunk_begin_vec[c+1]-1 */
+        vector<int> chunk_begin_vec;
+
+        /* expected number of edges */
+        double num_edge;
+
+        /* random, bipartite: probability of an edge */
+        double prob;
+
+        /* powerlaw: node weights, and their sum */
+        DoubleVec node_wgt_vec;
+        double sum_wgt;
+
+        /* knn: points (x,y), and the points of each cell of a num_grid x
+         * num_grid grid, cell_point_vec[cell_begin_vec[g] .. cell_begin_vec[g+1]-1] */
+        DoubleVec point_vec;
+        int num_grid;
+        vector<int> cell_begin_vec;
+        vector<int> cell_point_vec;
+
+};
+
+
+/* kind of a synthetic graph by name: random, powerlaw, block, dense,
+ * bipartite or knn, 0 if unknown */
+int synthetic_kind(const string & name);
+
+/* name of a kind of synthetic graph */
+string synthetic_name(const int & kind);
+
+/* distribution of the weights by name: uniform, exp, int, const or dist,
+ * 0 if unknown */
+int synthetic_wgt_kind(const string & name);
+
+/*
+ * synthetic graph of num_node nodes drawn from seed, as an upper triangle
+ * ijw (i<j), with weights uniform in (0,1]; avg_deg is the
+ * average degree, the number of neighbours of knn, and one less than the
+ * size of the blocks
+ *
+ * returns success (1) or failure (0) for an unknown kind
+ * */
+int synthetic_ijw(const int & kind, const int & num_node, const double & avg_deg, const unsigned int & seed, int & num_ijw, DoubleVec & ijw_vec);
+
+
+#endif
+
@@ -0,0 +1,69 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#ifndef _VERIFY_BMATCH_H_
+#define _VERIFY_BMATCH_H_
+
+#include <iostream>
+using namespace std;
+#include "Vector.hpp"
+
+
+/*
+ * check of a b-matching against its problem, in O(n + m + k) time for n
+ * nodes, m entries of the ijw and k matched edges
+ *
+ * the graph is that of the solvers: the entries with i <= j, duplicates
+ * added, zeros dropped; a matched edge (i,j) stands for the edge of
+ * (min(i,j), max(i,j)), and a self-loop takes 2 of the degree of its node
+ *
+ * upper_bound is the LP bound (1/2) sum_i (sum of the u_i heaviest
+ * positive edges of node i), which no b-matching exceeds; ratio is the
+ * weight over it, a lower bound on the approximation ratio of the solve
+ * */
+class BmatchVerification
+{
+    public:
+        /* matched edges out of range, or not edges of the graph */
+        int num_bad_edge;
+
+        /* matched edges listed more than once */
+        int num_dup_edge;
+
+        /* nodes above their upper bound, and the total excess */
+        int num_over_node;
+        double excess;
+
+        /* nodes below their (positive) lower bound, and the total deficit */
+        int num_under_node;
+        double deficit;
+
+        /* weight of the b-matching, from the weights of the graph, and its
+         * difference from the reported weight */
+        double wgt;
+        double wgt_error;
+
+        /* LP upper bound, and wgt / upper_bound (1 if the bound is 0) */
+        double upper_bound;
+        double ratio;
+
+        /* number of violations, 0 => a feasible b-matching of the reported
+         * weight */
+        int num_violation() const;
+
+        /* "prefix ..." lines: the weight, bound and ratio (without is_bound,
+         * the weight alone), and each kind of violation */
+        void write(ostream & out, const string & prefix = "", const int & is_bound = 1) const;
+};
+
+
+/* check the num_bmatch_edge edges of bmatch_edge_vec, of reported weight
+ * bmatch_wgt, against the degree bounds and the ijw of the problem; with
+ * is_full, the output of BP, an edge (i,j) counts towards the degree of i
+ * only, and half its weight towards the b-matching */
+void verify_bmatching(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, const int & num_bmatch_edge, const DoubleVec & bmatch_edge_vec, const double & bmatch_wgt, const int & is_full, BmatchVerification & V);
+
+
+#endif
+
@@ -6,7 +6,14 @@
 int AbstractBmatchSolver::
 solve_bmatching_problem(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
 {
-    return 0;
+    return solve_bmatching_view(num_node, deg_bdd_vec, num_ijw, IjwView(ijw_vec), num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+}
+
+/* the local copy of the ijw, the b-matching and the degree bounds */
+double AbstractBmatchSolver::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return 48.0*double(num_ijw) + 64.0*double(num_node);
 }
 
 /* */
@@ -0,0 +1,294 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <iomanip>
+#include <pthread.h>
+#include "SolveProfile.hpp"
+
+
+/* the solver log of each thread, NULL => cerr */
+static pthread_key_t solver_log_key;
+static pthread_once_t solver_log_once = PTHREAD_ONCE_INIT;
+
+static void solver_log_key_create()
+{
+    pthread_key_create(&solver_log_key, NULL);
+}
+
+
+/* wall-clock time in seconds, with microsecond resolution */
+double wall_clock()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return double(tv.tv_sec) + 1e-6*double(tv.tv_usec);
+}
+/* end wall_clock */
+
+
+/* peak resident set size of the process in megabytes, 0 if unknown */
+double peak_rss_mb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)!=0)
+    {
+        return 0.0;
+    }
+#ifdef __APPLE__
+    /* bytes */
+    return double(usage.ru_maxrss)/1048576.0;
+#else
+    /* kilobytes */
+    return double(usage.ru_maxrss)/1024.0;
+#endif
+}
+/* end peak_rss_mb */
+
+
+/* */
+ostream & solver_log()
+{
+    ostream * log_ptr;
+
+    pthread_once(&solver_log_once, solver_log_key_create);
+    log_ptr = (ostream *)pthread_getspecific(solver_log_key);
+    return log_ptr ? *log_ptr : cerr;
+}
+/* end solver_log */
+
+
+/* */
+void set_solver_log(ostream * log_ptr)
+{
+    pthread_once(&solver_log_once, solver_log_key_create);
+    pthread_setspecific(solver_log_key, log_ptr);
+}
+/* end set_solver_log */
+
+
+/* forget all phases, counters and timers */
+void SolveProfile::
+clear()
+{
+    phase_name_vec.clear();
+    phase_sec_vec.clear();
+    phase_start_vec.clear();
+    phase_rss_vec.clear();
+    counter_name_vec.clear();
+    counter_val_vec.clear();
+    goblin_name_vec.clear();
+    goblin_msec_vec.clear();
+    log_str.clear();
+}
+/* end clear */
+
+
+/* index of name in name_vec, appending it if necessary */
+int SolveProfile::
+lookup(vector<string> & name_vec, DoubleVec & val_vec, const string & name)
+{
+    register int k;
+    for (k=0; k<int(name_vec.size()); k++)
+    {
+        if (name_vec[k]==name)
+        {
+            return k;
+        }
+    }
+    name_vec.push_back(name);
+    val_vec.push_back(0.0);
+    return k;
+}
+/* end lookup */
+
+
+/* start the clock of a named phase */
+void SolveProfile::
+start(const string & phase)
+{
+    int k = lookup(phase_name_vec, phase_sec_vec, phase);
+    phase_start_vec.resize(phase_sec_vec.size(), 0.0);
+    phase_start_vec[k] = wall_clock();
+}
+/* end start */
+
+
+/* stop the clock of a named phase */
+void SolveProfile::
+stop(const string & phase)
+{
+    int k = lookup(phase_name_vec, phase_sec_vec, phase);
+    phase_start_vec.resize(phase_sec_vec.size(), 0.0);
+    phase_rss_vec.resize(phase_sec_vec.size(), 0.0);
+    if (phase_start_vec[k]>0.0)
+    {
+        phase_sec_vec[k] += wall_clock() - phase_start_vec[k];
+        phase_start_vec[k] = 0.0;
+        phase_rss_vec[k] = max(phase_rss_vec[k], peak_rss_mb());
+    }
+}
+/* end stop */
+
+
+/* accumulated time of a named phase, 0 if never started */
+double SolveProfile::
+phase_time(const string & phase) const
+{
+    register int k;
+    for (k=0; k<int(phase_name_vec.size()); k++)
+    {
+        if (phase_name_vec[k]==phase)
+        {
+            return phase_sec_vec[k];
+        }
+    }
+    return 0.0;
+}
+/* end phase_time */
+
+
+/* add val to a named counter */
+void SolveProfile::
+count(const string & name, const double & val)
+{
+    int k = lookup(counter_name_vec, counter_val_vec, name);
+    counter_val_vec[k] += val;
+}
+/* end count */
+
+
+/* record a goblin internal timer (msec) */
+void SolveProfile::
+goblin_timer(const string & name, const double & msec)
+{
+    int k = lookup(goblin_name_vec, goblin_msec_vec, name);
+    goblin_msec_vec[k] += msec;
+}
+/* end goblin_timer */
+
+
+/* write string as a quoted JSON string */
+void write_json_string(ostream & out, const string & str)
+{
+    register unsigned int k;
+    out << '"';
+    for (k=0; k<str.size(); k++)
+    {
+        if ((str[k]=='"') || (str[k]=='\\'))
+        {
+            out << '\\';
+        }
+        if (str[k]=='\n')
+        {
+            out << "\\n";
+        }
+        else if (str[k]>=' ')
+        {
+            out << str[k];
+        }
+    }
+    out << '"';
+}
+/* end write_json_string */
+
+
+/* write named values as the members of a JSON object */
+static void write_json_members(ostream & out, const vector<string> & name_vec, const DoubleVec & val_vec)
+{
+    register int k;
+    out << "{";
+    for (k=0; k<int(name_vec.size()); k++)
+    {
+        if (k>0)
+        {
+            out << ", ";
+        }
+        write_json_string(out, name_vec[k]);
+        out << ": " << val_vec[k];
+    }
+    out << "}";
+}
+/* end write_json_members */
+
+
+/* write phases and counters as "prefix name = value" lines, aligned as
+ * the summary of bmatch */
+void SolveProfile::
+write_summary(ostream & out, const string & prefix) const
+{
+    register int k;
+    for (k=0; k<int(phase_name_vec.size()); k++)
+    {
+        out << setw(13) << (prefix + phase_name_vec[k] + " (sec.)") << " = " << phase_sec_vec[k];
+        if ((k<int(phase_rss_vec.size())) && (phase_rss_vec[k]>0.0))
+        {
+            out << ", peak rss " << phase_rss_vec[k] << " MB";
+        }
+        out << endl;
+    }
+    for (k=0; k<int(counter_name_vec.size()); k++)
+    {
+        out << setw(13) << (prefix + counter_name_vec[k]) << " = " << counter_val_vec[k] << endl;
+    }
+}
+/* end write_summary */
+
+
+/* write profile as a JSON object */
+void SolveProfile::
+write_json(ostream & out) const
+{
+    streamsize precision = out.precision(9);
+
+    DoubleVec rss_vec(phase_rss_vec);
+    rss_vec.resize(phase_sec_vec.size(), 0.0);
+
+    out << "{\"phases_sec\": ";
+    write_json_members(out, phase_name_vec, phase_sec_vec);
+    out << ", \"phases_peak_rss_mb\": ";
+    write_json_members(out, phase_name_vec, rss_vec);
+    out << ", \"counters\": ";
+    write_json_members(out, counter_name_vec, counter_val_vec);
+    out << ", \"goblin_timers_msec\": ";
+    write_json_members(out, goblin_name_vec, goblin_msec_vec);
+    if (!log_str.empty())
+    {
+        out << ", \"log\": ";
+        write_json_string(out, log_str);
+    }
+    out << "}";
+
+    out.precision(precision);
+}
+/* end write_json */
+
+
+/* write summary of a solve and its profile as a JSON object */
+void write_solve_json(ostream & out, const string & method_str, const int & num_node, const int & num_ijw, const int & num_bmatch_edge, const double & bmatch_wgt, const int & success, const double & total_sec, const SolveProfile & profile, const SolveProfile * run_profile)
+{
+    streamsize precision = out.precision(12);
+
+    out << "{\"method\": ";
+    write_json_string(out, method_str);
+    out << ", \"num_node\": " << num_node;
+    out << ", \"num_ijw\": " << num_ijw;
+    out << ", \"num_bmatch_edge\": " << num_bmatch_edge;
+    out << ", \"bmatch_wgt\": " << bmatch_wgt;
+    out << ", \"success\": " << success;
+    out << ", \"total_sec\": " << total_sec;
+    out << ", \"profile\": ";
+    profile.write_json(out);
+    if (run_profile!=NULL)
+    {
+        out << ", \"run\": ";
+        run_profile->write_json(out);
+    }
+    out << "}" << endl;
+
+    out.precision(precision);
+}
+/* end write_solve_json */
@@ -6,6 +6,7 @@
 using namespace std;
 #include "Vector.hpp"
 #include <cmath>
+#include <algorithm>
 
 
 // compute the inner product of two sparse vectors
@@ -447,3 +448,482 @@ void ijw_transpose(int & num_ijw, DoubleVec & ijw_vec)
 
 
 
+
+
+/* orders entry indices of an ijw array by (i,j) */
+class ijw_index_less
+{
+    public:
+        ijw_index_less(const IjwView & in_ijw_view) : ijw_view(in_ijw_view) {};
+
+        bool operator()(const int & k1, const int & k2) const
+        {
+            if (ijw_view.i(k1)!=ijw_view.i(k2))
+            {
+                return (ijw_view.i(k1)<ijw_view.i(k2));
+            }
+            return (ijw_view.j(k1)<ijw_view.j(k2));
+        }
+
+    private:
+        IjwView ijw_view;
+};
+
+
+/* row-major copy of the num_ijw entries */
+void IjwView::
+copy(const int & num_ijw, DoubleVec & ijw_vec) const
+{
+    register int k;
+
+    ijw_vec.resize(3*num_ijw);
+    for (k=0; k<num_ijw; k++)
+    {
+        ijw_vec[3*k+0] = i(k);
+        ijw_vec[3*k+1] = j(k);
+        ijw_vec[3*k+2] = w(k);
+    }
+}
+/* end IjwView::copy */
+
+
+/* keep only upper triangle (i<=j) entries whose nodes are both marked 
+ * in keep_vec, adding duplicate weights and dropping zero sums, 
+ * in (i,j) order
+ *
+ * this gives the same ijw array as ijw_2_svecvec_symm, clearing the rows 
+ * and columns of the unmarked nodes, svecvec_2_ijw and ijw_upper_tri, 
+ * without the sparse matrix
+ * */
+void ijw_keep_upper_tri(int & num_ijw, DoubleVec & ijw_vec, const vector<bool> & keep_vec)
+{
+    int L_num_ijw;
+    DoubleVec L_ijw_vec;
+
+    ijw_keep_upper_tri(IjwView(ijw_vec), num_ijw, keep_vec, L_num_ijw, L_ijw_vec);
+    ijw_vec.swap(L_ijw_vec);
+    num_ijw = L_num_ijw;
+}
+
+/* the same, into out_ijw_vec, reading the input through a view, so that 
+ * the filtered upper triangle is the only copy made of it */
+void ijw_keep_upper_tri(const IjwView & ijw_view, const int & num_ijw, const vector<bool> & keep_vec, int & out_num_ijw, DoubleVec & out_ijw_vec)
+{
+    register int i;
+    register int j;
+    register int k;
+    register int kk;
+    register double wgt;
+    vector<int> index_vec;
+
+    /* marked upper triangle entries, sorted stably so that duplicates 
+     * are added in input order */
+    index_vec.reserve(num_ijw);
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_view.i(k));
+        j = int(ijw_view.j(k));
+        if ((i<=j) && keep_vec[i] && keep_vec[j])
+        {
+            index_vec.push_back(k);
+        }
+    }
+    stable_sort(index_vec.begin(), index_vec.end(), ijw_index_less(ijw_view));
+
+    /* add duplicates and drop zeros */
+    out_ijw_vec.clear();
+    out_ijw_vec.reserve(3*index_vec.size());
+    for (k=0; k<int(index_vec.size()); k=kk)
+    {
+        i = int(ijw_view.i(index_vec[k]));
+        j = int(ijw_view.j(index_vec[k]));
+        wgt = 0.0;
+        for (kk=k; kk<int(index_vec.size()); kk++)
+        {
+            if ((int(ijw_view.i(index_vec[kk]))!=i) || (int(ijw_view.j(index_vec[kk]))!=j))
+            {
+                break;
+            }
+            wgt += ijw_view.w(index_vec[kk]);
+        }
+        if (wgt!=0)
+        {
+            out_ijw_vec.push_back(i);
+            out_ijw_vec.push_back(j);
+            out_ijw_vec.push_back(wgt);
+        }
+    }
+    out_num_ijw = int(out_ijw_vec.size()/3);
+}
+/* end ijw_keep_upper_tri */
+
+
+/* weight of entry (i,j) of an ijw array in (i,j) order without 
+ * duplicates, 0 if missing */
+double ijw_sorted_weight(const int & num_ijw, const DoubleVec & ijw_vec, const int & i, const int & j)
+{
+    register int lo;
+    register int hi;
+    register int mid;
+
+    lo = 0;
+    hi = num_ijw;
+    while (lo<hi)
+    {
+        mid = lo + (hi - lo)/2;
+        if ((ijw_vec[3*mid+0]<i) || ((ijw_vec[3*mid+0]==i) && (ijw_vec[3*mid+1]<j)))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if ((lo<num_ijw) && (ijw_vec[3*lo+0]==i) && (ijw_vec[3*lo+1]==j))
+    {
+        return ijw_vec[3*lo+2];
+    }
+    return 0.0;
+}
+/* end ijw_sorted_weight */
+
+
+/* entries of A that are not entries of B, with weight 1, where A is in
+ * (i,j) order without duplicates and B is any upper triangle ijw array */
+void ijw_logical_difference(const int & num_a_ijw, const DoubleVec & a_ijw_vec, const int & num_b_ijw, const DoubleVec & b_ijw_vec, int & num_ijw, DoubleVec & ijw_vec)
+{
+    register int k;
+    register int kb;
+    vector<int> index_vec(num_b_ijw);
+
+    for (k=0; k<num_b_ijw; k++)
+    {
+        index_vec[k] = k;
+    }
+    sort(index_vec.begin(), index_vec.end(), ijw_index_less(b_ijw_vec));
+
+    /* merge */
+    ijw_vec.clear();
+    ijw_vec.reserve(3*max(num_a_ijw - num_b_ijw, 0));
+    kb = 0;
+    for (k=0; k<num_a_ijw; k++)
+    {
+        while ((kb<num_b_ijw) && 
+            ((b_ijw_vec[3*index_vec[kb]+0]<a_ijw_vec[3*k+0]) || 
+             ((b_ijw_vec[3*index_vec[kb]+0]==a_ijw_vec[3*k+0]) && (b_ijw_vec[3*index_vec[kb]+1]<a_ijw_vec[3*k+1]))))
+        {
+            kb++;
+        }
+        if ((kb<num_b_ijw) && 
+            (b_ijw_vec[3*index_vec[kb]+0]==a_ijw_vec[3*k+0]) && 
+            (b_ijw_vec[3*index_vec[kb]+1]==a_ijw_vec[3*k+1]))
+        {
+            continue;
+        }
+        ijw_vec.push_back(a_ijw_vec[3*k+0]);
+        ijw_vec.push_back(a_ijw_vec[3*k+1]);
+        ijw_vec.push_back(1.0);
+    }
+    num_ijw = int(ijw_vec.size()/3);
+}
+/* end ijw_logical_difference */
+
+
+/* orders entry indices of an ijw array by decreasing weight, then index */
+class ijw_index_heavier
+{
+    public:
+        ijw_index_heavier(const DoubleVec & in_ijw_vec) : ijw_vec(in_ijw_vec) {};
+
+        bool operator()(const int & k1, const int & k2) const
+        {
+            if (ijw_vec[3*k1+2]!=ijw_vec[3*k2+2])
+            {
+                return (ijw_vec[3*k1+2]>ijw_vec[3*k2+2]);
+            }
+            return (k1<k2);
+        }
+
+    private:
+        const DoubleVec & ijw_vec;
+};
+
+
+/* keep only the entries that are among the k_vec[i] heaviest entries of 
+ * node i, or the k_vec[j] heaviest of node j, in the same order; ties are 
+ * broken by entry index, and a self-loop is one entry of its node */
+void ijw_keep_topk(int & num_ijw, DoubleVec & ijw_vec, const int & num_node, const vector<int> & k_vec)
+{
+    register int i;
+    register int j;
+    register int k;
+    vector<int> row_begin_vec(num_node+1, 0);
+    vector<int> row_end_vec;
+    vector<int> row_entry_vec;
+    vector<char> keep_vec(num_ijw, 0);
+    vector<int>::iterator first;
+    vector<int>::iterator last;
+    DoubleVec L_ijw_vec;
+
+    /* entries of each node */
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        row_begin_vec[i+1] += 1;
+        if (i!=j)
+        {
+            row_begin_vec[j+1] += 1;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        row_begin_vec[i+1] += row_begin_vec[i];
+    }
+    row_entry_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        row_entry_vec[row_end_vec[i]++] = k;
+        if (i!=j)
+        {
+            row_entry_vec[row_end_vec[j]++] = k;
+        }
+    }
+
+    /* partial selection of the heaviest entries of each node */
+    for (i=0; i<num_node; i++)
+    {
+        first = row_entry_vec.begin() + row_begin_vec[i];
+        last = row_entry_vec.begin() + row_begin_vec[i+1];
+        if (int(last - first)>max(k_vec[i], 0))
+        {
+            last = first + max(k_vec[i], 0);
+            nth_element(first, last, row_entry_vec.begin() + row_begin_vec[i+1], ijw_index_heavier(ijw_vec));
+        }
+        for (; first!=last; first++)
+        {
+            keep_vec[*first] = 1;
+        }
+    }
+
+    /* */
+    L_ijw_vec.reserve(ijw_vec.size());
+    for (k=0; k<num_ijw; k++)
+    {
+        if (keep_vec[k])
+        {
+            L_ijw_vec.push_back(ijw_vec[3*k+0]);
+            L_ijw_vec.push_back(ijw_vec[3*k+1]);
+            L_ijw_vec.push_back(ijw_vec[3*k+2]);
+        }
+    }
+    ijw_vec.swap(L_ijw_vec);
+    num_ijw = int(ijw_vec.size()/3);
+}
+/* end ijw_keep_topk */
+
+
+/* orders nodes by degree, then index */
+class node_degree_less
+{
+    public:
+        node_degree_less(const vector<int> & in_deg_vec, const bool & in_is_descending) : deg_vec(in_deg_vec), is_descending(in_is_descending) {};
+
+        bool operator()(const int & u, const int & v) const
+        {
+            if (deg_vec[u]!=deg_vec[v])
+            {
+                return (is_descending ? (deg_vec[u]>deg_vec[v]) : (deg_vec[u]<deg_vec[v]));
+            }
+            return (u<v);
+        }
+
+    private:
+        const vector<int> & deg_vec;
+        bool is_descending;
+};
+
+
+/* order of the nodes of an ijw graph, order_vec[new] = old
+ *
+ * method 1 sorts the nodes by decreasing degree; method 2 is a breadth-
+ * first (Cuthill-McKee) order, each component from a node of least 
+ * degree and the neighbours of a node by increasing degree; method 3 is 
+ * the reverse of method 2 (RCM); otherwise the order is the identity */
+void ijw_node_order(const int & num_node, const int & num_ijw, const DoubleVec & ijw_vec, const int & method, vector<int> & order_vec)
+{
+    register int i;
+    register int j;
+    register int k;
+    int head;
+    int num_order;
+    vector<int> deg_vec(num_node, 0);
+    vector<int> row_begin_vec(num_node+1, 0);
+    vector<int> row_end_vec;
+    vector<int> row_node_vec;
+    vector<int> start_vec;
+    vector<char> seen_vec;
+
+    order_vec.resize(num_node);
+    for (i=0; i<num_node; i++)
+    {
+        order_vec[i] = i;
+    }
+    if ((method<1) || (method>3))
+    {
+        return;
+    }
+
+    /* degrees, without self-loops */
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        if (i!=j)
+        {
+            deg_vec[i] += 1;
+            deg_vec[j] += 1;
+        }
+    }
+    if (method==1)
+    {
+        stable_sort(order_vec.begin(), order_vec.end(), node_degree_less(deg_vec, true));
+        return;
+    }
+
+    /* neighbours of each node, by increasing degree */
+    for (i=0; i<num_node; i++)
+    {
+        row_begin_vec[i+1] = row_begin_vec[i] + deg_vec[i];
+    }
+    row_node_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        if (i!=j)
+        {
+            row_node_vec[row_end_vec[i]++] = j;
+            row_node_vec[row_end_vec[j]++] = i;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        sort(row_node_vec.begin() + row_begin_vec[i], row_node_vec.begin() + row_begin_vec[i+1], node_degree_less(deg_vec, false));
+    }
+
+    /* breadth-first, each component from a node of least degree */
+    start_vec = order_vec;
+    stable_sort(start_vec.begin(), start_vec.end(), node_degree_less(deg_vec, false));
+    seen_vec.assign(num_node, 0);
+    num_order = 0;
+    for (k=0; k<num_node; k++)
+    {
+        if (seen_vec[start_vec[k]])
+        {
+            continue;
+        }
+        seen_vec[start_vec[k]] = 1;
+        order_vec[num_order++] = start_vec[k];
+        for (head=num_order-1; head<num_order; head++)
+        {
+            i = order_vec[head];
+            for (j=row_begin_vec[i]; j<row_begin_vec[i+1]; j++)
+            {
+                if (!seen_vec[row_node_vec[j]])
+                {
+                    seen_vec[row_node_vec[j]] = 1;
+                    order_vec[num_order++] = row_node_vec[j];
+                }
+            }
+        }
+    }
+    if (method==3)
+    {
+        reverse(order_vec.begin(), order_vec.end());
+    }
+}
+/* end ijw_node_order */
+
+
+/* relabel the nodes of an ijw array, i => label_vec[i], in (i,j) order; 
+ * if is_upper_tri, the entries are kept in the upper triangle (i<=j) */
+void ijw_relabel(const int & num_ijw, DoubleVec & ijw_vec, const vector<int> & label_vec, const int & is_upper_tri)
+{
+    register int i;
+    register int j;
+    register int k;
+    vector<int> index_vec(num_ijw);
+    DoubleVec L_ijw_vec(ijw_vec.size());
+
+    for (k=0; k<num_ijw; k++)
+    {
+        i = label_vec[int(ijw_vec[3*k+0])];
+        j = label_vec[int(ijw_vec[3*k+1])];
+        if (is_upper_tri && (i>j))
+        {
+            swap(i, j);
+        }
+        ijw_vec[3*k+0] = i;
+        ijw_vec[3*k+1] = j;
+        index_vec[k] = k;
+    }
+    stable_sort(index_vec.begin(), index_vec.end(), ijw_index_less(ijw_vec));
+    for (k=0; k<num_ijw; k++)
+    {
+        L_ijw_vec[3*k+0] = ijw_vec[3*index_vec[k]+0];
+        L_ijw_vec[3*k+1] = ijw_vec[3*index_vec[k]+1];
+        L_ijw_vec[3*k+2] = ijw_vec[3*index_vec[k]+2];
+    }
+    ijw_vec.swap(L_ijw_vec);
+}
+/* end ijw_relabel */
+
+
+/* bandwidth of an ijw array, max |i-j| */
+int ijw_bandwidth(const int & num_ijw, const DoubleVec & ijw_vec)
+{
+    register int k;
+    int bandwidth = 0;
+
+    for (k=0; k<num_ijw; k++)
+    {
+        bandwidth = max(bandwidth, abs(int(ijw_vec[3*k+0]) - int(ijw_vec[3*k+1])));
+    }
+    return bandwidth;
+}
+/* end ijw_bandwidth */
+
+
+/* rank_vec[k] of 0..num-1: k if seed is 0, otherwise a permutation drawn 
+ * from seed by a Fisher-Yates shuffle with a 32-bit xorshift generator, 
+ * so that it does not depend on the platform's rand() */
+void seeded_rank(const int & num, const unsigned int & seed, vector<int> & rank_vec)
+{
+    register int k;
+    unsigned int x;
+
+    rank_vec.resize(num);
+    for (k=0; k<num; k++)
+    {
+        rank_vec[k] = k;
+    }
+    if (seed==0)
+    {
+        return;
+    }
+    x = seed;
+    for (k=num-1; k>0; k--)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        swap(rank_vec[k], rank_vec[x % (unsigned int)(k+1)]);
+    }
+}
+/* end seeded_rank */
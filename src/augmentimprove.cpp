@@ -0,0 +1,410 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <algorithm>
+#include "augmentimprove.hpp"
+
+
+/* edge e1 before edge e2 in a row: heavier, or as heavy with a smaller index */
+class augment_edge_before
+{
+    public:
+        augment_edge_before(const DoubleVec & in_edge_wgt_vec) : edge_wgt_vec(in_edge_wgt_vec) {};
+
+        bool operator()(const int & e1, const int & e2) const
+        {
+            if (edge_wgt_vec[e1]!=edge_wgt_vec[e2])
+            {
+                return (edge_wgt_vec[e1]>edge_wgt_vec[e2]);
+            }
+            return (e1<e2);
+        }
+
+    private:
+        const DoubleVec & edge_wgt_vec;
+};
+
+
+/* */
+string AugmentImproveBmatch::
+description()
+{
+    return description_str;
+}
+
+
+/* improve the b-matching bmatch_edge_vec of the problem, in place */
+int AugmentImproveBmatch::
+improve_bmatching(const int & in_num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+{
+    register int i;
+    register int j;
+    register int k;
+    register int e;
+    int lo;
+    int hi;
+    int mid;
+    int num_ijw;
+    int num_pass;
+    int num_move;
+    double wgt0;
+    double pass_gain;
+    double min_gain;
+    DoubleVec ijw_vec;
+    vector<bool> keep_vec;
+    vector<int> row_end_vec;
+
+    num_node = in_num_node;
+    profile.start("improve");
+
+    /* check for positive wgts */
+    for (k=0; k<in_num_ijw; k++) {
+        if (in_ijw_vec[3*k + 2]<0) {
+            solver_log() << " bmatch_ijw!> weights must be positive " << endl;
+            profile.stop("improve");
+            return 0;
+        }
+    }
+
+    /* upper triangle between nodes with a non-zero upper bound */
+    num_ijw = in_num_ijw;
+    ijw_vec = in_ijw_vec;
+    keep_vec.resize(num_node);
+    for (i=0; i<num_node; i++)
+    {
+        keep_vec[i] = (deg_bdd_vec[2*i+1]!=0);
+    }
+    ijw_keep_upper_tri(num_ijw, ijw_vec, keep_vec);
+
+    /* edges, and rows without self-loops */
+    edge_u_vec.resize(num_ijw);
+    edge_v_vec.resize(num_ijw);
+    edge_wgt_vec.resize(num_ijw);
+    row_begin_vec.assign(num_node+1, 0);
+    deg_vec.assign(num_node, 0);
+    max_wgt = 0.0;
+    for (e=0; e<num_ijw; e++)
+    {
+        i = int(ijw_vec[3*e+0]);
+        j = int(ijw_vec[3*e+1]);
+        edge_u_vec[e] = i;
+        edge_v_vec[e] = j;
+        edge_wgt_vec[e] = ijw_vec[3*e+2];
+        max_wgt = max(max_wgt, edge_wgt_vec[e]);
+        deg_vec[i] += 1;
+        deg_vec[j] += 1;
+        if (i!=j)
+        {
+            row_begin_vec[i+1] += 1;
+            row_begin_vec[j+1] += 1;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        row_begin_vec[i+1] += row_begin_vec[i];
+    }
+    row_edge_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (e=0; e<num_ijw; e++)
+    {
+        if (edge_u_vec[e]!=edge_v_vec[e])
+        {
+            row_edge_vec[row_end_vec[edge_u_vec[e]]++] = e;
+            row_edge_vec[row_end_vec[edge_v_vec[e]]++] = e;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        sort(row_edge_vec.begin() + row_begin_vec[i], row_edge_vec.begin() + row_begin_vec[i+1], augment_edge_before(edge_wgt_vec));
+    }
+
+    /* bounds, clamped to the degrees (self-loops=2) */
+    lb_vec.resize(num_node);
+    ub_vec.resize(num_node);
+    for (i=0; i<num_node; i++)
+    {
+        lb_vec[i] = max(0, min(int(deg_bdd_vec[2*i+0]), deg_vec[i]));
+        ub_vec[i] = max(0, min(int(deg_bdd_vec[2*i+1]), deg_vec[i]));
+    }
+
+    /* initial matching, either triangle, ignoring missing edges */
+    match_vec.assign(num_ijw, 0);
+    for (k=0; k<num_bmatch_edge; k++)
+    {
+        i = int(min(bmatch_edge_vec[3*k+0], bmatch_edge_vec[3*k+1]));
+        j = int(max(bmatch_edge_vec[3*k+0], bmatch_edge_vec[3*k+1]));
+        if (bmatch_edge_vec[3*k+2]==0)
+        {
+            continue;
+        }
+        lo = 0;
+        hi = num_ijw;
+        while (lo<hi)
+        {
+            mid = lo + (hi - lo)/2;
+            if ((edge_u_vec[mid]<i) || ((edge_u_vec[mid]==i) && (edge_v_vec[mid]<j)))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if ((lo<num_ijw) && (edge_u_vec[lo]==i) && (edge_v_vec[lo]==j))
+        {
+            match_vec[lo] = 1;
+        }
+    }
+
+    /* degrees of the matching */
+    deg_vec.assign(num_node, 0);
+    for (e=0; e<num_ijw; e++)
+    {
+        if (match_vec[e])
+        {
+            deg_vec[edge_u_vec[e]] += 1;
+            deg_vec[edge_v_vec[e]] += 1;
+        }
+    }
+
+    /* drop the lightest edges, and then the self-loops, of nodes over
+     * their upper bounds */
+    for (i=0; i<num_node; i++)
+    {
+        for (k=row_begin_vec[i+1]-1; (k>=row_begin_vec[i]) && (deg_vec[i]>ub_vec[i]); k--)
+        {
+            e = row_edge_vec[k];
+            if (match_vec[e])
+            {
+                match_vec[e] = 0;
+                deg_vec[edge_u_vec[e]] -= 1;
+                deg_vec[edge_v_vec[e]] -= 1;
+            }
+        }
+    }
+    for (e=0; e<num_ijw; e++)
+    {
+        i = edge_u_vec[e];
+        if (match_vec[e] && (i==edge_v_vec[e]) && (deg_vec[i]>ub_vec[i]))
+        {
+            match_vec[e] = 0;
+            deg_vec[i] -= 2;
+        }
+    }
+
+    /* initial weight */
+    bmatch_wgt = 0.0;
+    for (e=0; e<num_ijw; e++)
+    {
+        if (match_vec[e])
+        {
+            bmatch_wgt += edge_wgt_vec[e];
+        }
+    }
+    wgt0 = bmatch_wgt;
+
+    /* passes of augmentations; gains below min_gain are round-off */
+    min_gain = 1e-12*max(1.0, max_wgt);
+    time0 = wall_clock();
+    is_timeout = false;
+    num_step = 0;
+    num_pass = 0;
+    num_move = 0;
+    while ((max_len>0) && (!is_timeout))
+    {
+        pass_gain = 0.0;
+        for (i=0; i<num_node; i++)
+        {
+            if ((time_limit>0) && (wall_clock() - time0 > time_limit))
+            {
+                is_timeout = true;
+                break;
+            }
+            best_gain = min_gain;
+            search(i);
+            if (is_timeout)
+            {
+                break;
+            }
+            if (best_path_vec.size()>0)
+            {
+                apply();
+                pass_gain += best_gain;
+                num_move += 1;
+            }
+        }
+        num_pass += 1;
+        bmatch_wgt += pass_gain;
+        if (verbose>1)
+        {
+            solver_log() << " AugmentImproveBmatch> pass " << num_pass << " gain " << pass_gain << " wgt " << bmatch_wgt << endl;
+        }
+        if (pass_gain<=max(eps*bmatch_wgt, min_gain))
+        {
+            break;
+        }
+    }
+
+    /* solution, in (i,j) order, and its exact weight */
+    bmatch_edge_vec.clear();
+    bmatch_wgt = 0.0;
+    for (e=0; e<num_ijw; e++)
+    {
+        if (match_vec[e])
+        {
+            bmatch_edge_vec.push_back(edge_u_vec[e]);
+            bmatch_edge_vec.push_back(edge_v_vec[e]);
+            bmatch_edge_vec.push_back(1.0);
+            bmatch_wgt += edge_wgt_vec[e];
+        }
+    }
+    num_bmatch_edge = int(bmatch_edge_vec.size()/3);
+
+    profile.stop("improve");
+    profile.count("improve_passes", num_pass);
+    profile.count("improve_moves", num_move);
+    profile.count("improve_gain", bmatch_wgt - wgt0);
+    if (verbose>0)
+    {
+        solver_log() << " AugmentImproveBmatch> wgt " << wgt0 << " -> " << bmatch_wgt;
+        solver_log() << " (" << num_move << " augmentations in " << num_pass << " passes";
+        solver_log() << (is_timeout ? ", time limit reached)" : ")") << endl;
+    }
+    return 1;
+}
+/* end improve_bmatching */
+
+
+/* find the best augmentation from node s, into best_path_vec */
+void AugmentImproveBmatch::
+search(const int & s)
+{
+    path_vec.clear();
+    best_path_vec.clear();
+    extend(s, s, 1, 0.0);
+    extend(s, s, 0, 0.0);
+}
+/* end search */
+
+
+/* extend the alternating walk of path_vec, from s to x, whose next edge
+ * is added if add is non-zero and removed otherwise */
+void AugmentImproveBmatch::
+extend(const int & s, const int & x, const int & add, const double & gain)
+{
+    register int k;
+    register int kk;
+    register int e;
+    int num_add;
+
+    /* a walk may branch on every edge of its nodes, so the time limit is
+     * checked inside the search, not only between start nodes */
+    if (is_timeout)
+    {
+        return;
+    }
+    if ((time_limit>0) && (++num_step>=AUGMENT_CLOCK_STEPS))
+    {
+        num_step = 0;
+        if (wall_clock() - time0 > time_limit)
+        {
+            is_timeout = true;
+            return;
+        }
+    }
+
+    /* the walk so far */
+    if ((path_vec.size()>0) && (gain>best_gain) && is_feasible(s, x, add))
+    {
+        best_gain = gain;
+        best_path_vec = path_vec;
+    }
+
+    /* the remaining edges can add at most num_add edges */
+    if (int(path_vec.size())>=max_len)
+    {
+        return;
+    }
+    num_add = (max_len - int(path_vec.size()) + (add ? 1 : 0))/2;
+    if (gain + num_add*max_wgt<=best_gain)
+    {
+        return;
+    }
+
+    for (k=row_begin_vec[x]; k<row_begin_vec[x+1]; k++)
+    {
+        e = row_edge_vec[k];
+        if ((match_vec[e]!=0)==(add!=0))
+        {
+            continue;
+        }
+        for (kk=0; kk<int(path_vec.size()); kk++)
+        {
+            if (path_vec[kk]==e)
+            {
+                break;
+            }
+        }
+        if (kk<int(path_vec.size()))
+        {
+            continue;
+        }
+        path_vec.push_back(e);
+        extend(s, edge_u_vec[e] + edge_v_vec[e] - x, !add, add ? gain + edge_wgt_vec[e] : gain - edge_wgt_vec[e]);
+        path_vec.pop_back();
+    }
+}
+/* end extend */
+
+
+/* true if the degrees of the end nodes s and x of the walk stay within
+ * bounds, the inner nodes of the walk keeping their degrees */
+bool AugmentImproveBmatch::
+is_feasible(const int & s, const int & x, const int & add) const
+{
+    int ds;
+    int dx;
+
+    /* the first edge is added if unmatched, and the last one if the next
+     * one would be removed */
+    ds = match_vec[path_vec[0]] ? -1 : 1;
+    dx = add ? -1 : 1;
+    if (s==x)
+    {
+        ds += dx;
+        dx = 0;
+    }
+    if ((deg_vec[s] + ds>ub_vec[s]) || ((ds<0) && (deg_vec[s] + ds<lb_vec[s])))
+    {
+        return false;
+    }
+    if ((deg_vec[x] + dx>ub_vec[x]) || ((dx<0) && (deg_vec[x] + dx<lb_vec[x])))
+    {
+        return false;
+    }
+    return true;
+}
+/* end is_feasible */
+
+
+/* toggle the edges of best_path_vec */
+void AugmentImproveBmatch::
+apply()
+{
+    register int k;
+    register int e;
+    int d;
+
+    for (k=0; k<int(best_path_vec.size()); k++)
+    {
+        e = best_path_vec[k];
+        d = match_vec[e] ? -1 : 1;
+        match_vec[e] = !match_vec[e];
+        deg_vec[edge_u_vec[e]] += d;
+        deg_vec[edge_v_vec[e]] += d;
+    }
+}
+/* end apply */
+
@@ -0,0 +1,306 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <cmath>
+#include <iomanip>
+#include "autoselect.hpp"
+#include "newsolver.hpp"
+
+
+/* methods that method 0 chooses from, in order of preference on a tie;
+ * not the mincost method 2, nor BP (method 5), without a guarantee and
+ * with n^2 memory */
+static const int num_auto_method = 5;
+static const int auto_method_arr[num_auto_method] = {3, 6, 4, 7, 1};
+
+
+/* root of node i in the forest of parent_vec, with the parity of the path
+ * from i to the root; halves the paths */
+static int parity_find(vector<int> & parent_vec, vector<int> & parity_vec, int i, int & parity)
+{
+    register int p;
+
+    parity = 0;
+    while (parent_vec[i]!=i)
+    {
+        p = parent_vec[i];
+        if (parent_vec[p]!=p)
+        {
+            parity_vec[i] ^= parity_vec[p];
+            parent_vec[i] = parent_vec[p];
+        }
+        parity ^= parity_vec[i];
+        i = parent_vec[i];
+    }
+    return i;
+}
+/* end parity_find */
+
+
+/* features, over the entries in the upper triangle (i <= j) with non-zero
+ * weight, which is what the solvers keep */
+void problem_features(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, ProblemFeatures & F)
+{
+    register int i;
+    register int j;
+    register int k;
+    int ri;
+    int rj;
+    int pi;
+    int pj;
+    double ub;
+    vector<int> deg_vec(num_node, 0);
+    vector<int> parent_vec(num_node);
+    vector<int> parity_vec(num_node, 0);
+
+    F.num_node = num_node;
+    F.num_ijw = 0;
+    F.num_active = 0;
+    F.sum_ub = 0.0;
+    F.mean_ub = 0.0;
+    F.max_ub = 0.0;
+    F.has_lower_bound = 0;
+    F.is_bipartite = 1;
+
+    for (i=0; i<num_node; i++)
+    {
+        parent_vec[i] = i;
+        if (deg_bdd_vec[2*i]>0)
+        {
+            F.has_lower_bound = 1;
+        }
+    }
+
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_view.i(k));
+        j = int(ijw_view.j(k));
+        if ((i>j) || (i<0) || (j>=num_node) || (ijw_view.w(k)==0))
+        {
+            continue;
+        }
+        F.num_ijw++;
+        if ((deg_bdd_vec[2*i+1]<=0) || (deg_bdd_vec[2*j+1]<=0))
+        {
+            continue;
+        }
+        deg_vec[i]++;
+        deg_vec[j]++;
+
+        /* i and j of different colours */
+        if (!F.is_bipartite)
+        {
+            continue;
+        }
+        ri = parity_find(parent_vec, parity_vec, i, pi);
+        rj = parity_find(parent_vec, parity_vec, j, pj);
+        if (ri==rj)
+        {
+            F.is_bipartite = (pi!=pj);
+        }
+        else
+        {
+            parent_vec[rj] = ri;
+            parity_vec[rj] = pi ^ pj ^ 1;
+        }
+    }
+
+    for (i=0; i<num_node; i++)
+    {
+        if (deg_vec[i]==0)
+        {
+            continue;
+        }
+        ub = min(deg_bdd_vec[2*i+1], double(deg_vec[i]));
+        F.num_active++;
+        F.sum_ub += ub;
+        F.max_ub = max(F.max_ub, ub);
+    }
+    if (F.num_active>0)
+    {
+        F.mean_ub = F.sum_ub/double(F.num_active);
+    }
+    F.density = (num_node>1) ? 2.0*double(F.num_ijw)/(double(num_node)*double(num_node-1)) : 0.0;
+}
+/* end problem_features */
+
+
+/* */
+double method_accuracy(const int & method)
+{
+    switch (method) {
+        case 1:
+        case 7:
+            return 1.0;
+        case 3:
+        case 4:
+        case 6:
+            return 0.5;
+        default:
+            return 0.0;
+    }
+}
+/* end method_accuracy */
+
+
+/* */
+int method_needs_bipartite(const int & method)
+{
+    return (method==7);
+}
+/* end method_needs_bipartite */
+
+
+/* the repair of the greedy methods 3-4 fills the nodes below their lower
+ * bounds when it can, with no guarantee; b-suitor (6) ignores them */
+int method_ignores_lower_bound(const int & method)
+{
+    return ((method==3) || (method==4) || (method==6));
+}
+/* end method_ignores_lower_bound */
+
+
+/*
+ * fitted with bmatch_bench to the solve time of random, bipartite and
+ * power-law graphs of 2000 to 100000 nodes, of 8 edges per node, with
+ * b = 1 and 4:
+ *
+ *   greedy (3)          2.2e-8 m log2 m, growing slowly with the mean bound
+ *   recursive (4)       1.1 x greedy
+ *   b-suitor (6)        1.15 x greedy on one thread, 70% efficient after
+ *   bipartite flow (7)  3e-8 m^1.5, within 3x over average degrees of
+ *                       8 to 32 and b = 1 to 8
+ *   exact (1)           3.2e-8 F m log2 n, for F = min(sum b / 2, m)
+ *                       augmenting paths (a guess, not fitted)
+ * */
+double method_cost_estimate(const int & method, const ProblemFeatures & F, const int & num_thread)
+{
+    double m = double(F.num_ijw);
+    double n = double(F.num_active);
+    double flow = min(0.5*F.sum_ub, m);
+    double greedy = 2.2e-8*m*log(m + 2.0)/log(2.0)*(1.0 + 0.25*log(1.0 + F.mean_ub)/log(2.0));
+
+    switch (method) {
+        case 3:
+            return greedy;
+        case 4:
+            return 1.1*greedy;
+        case 6:
+            return 1.15*greedy/(1.0 + 0.7*double(max(num_thread, 1) - 1));
+        case 7:
+            return 3e-8*m*sqrt(m);
+        case 1:
+            return 3.2e-8*flow*m*log(n + 2.0)/log(2.0);
+        default:
+            return INF;
+    }
+}
+/* end method_cost_estimate */
+
+
+/* memory estimate (bytes) of a method */
+static double method_memory_estimate(const int & method, const int & num_node, const int & num_ijw)
+{
+    AbstractBmatchSolver * ALG;
+    double estimate;
+
+    ALG = new_solver(method, Parameter());
+    if (ALG==NULL)
+    {
+        return INF;
+    }
+    estimate = ALG->memory_estimate(num_node, num_ijw);
+    delete ALG;
+    return estimate;
+}
+/* end method_memory_estimate */
+
+
+/* */
+int select_method(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, const double & accuracy, const double & max_mem, const int & num_thread, ostream * log_ptr)
+{
+    register int k;
+    int method;
+    int best_method = 0;
+    int fallback_method = 0;
+    double best_time = INF;
+    double fallback_time = INF;
+    double time;
+    double mem;
+    ProblemFeatures F;
+
+    problem_features(num_node, deg_bdd_vec, num_ijw, ijw_view, F);
+
+    if (log_ptr)
+    {
+        *log_ptr << "bmatch auto> n = " << F.num_node << " (" << F.num_active << " active), m = " << F.num_ijw;
+        *log_ptr << ", density = " << F.density << endl;
+        *log_ptr << "bmatch auto> mean b = " << F.mean_ub << ", max b = " << F.max_ub;
+        *log_ptr << ", lower bounds = " << (F.has_lower_bound ? "yes" : "no");
+        *log_ptr << ", bipartite = " << (F.is_bipartite ? "yes" : "no");
+        *log_ptr << ", accuracy >= " << accuracy << endl;
+    }
+
+    for (k=0; k<num_auto_method; k++)
+    {
+        method = auto_method_arr[k];
+        time = method_cost_estimate(method, F, num_thread);
+        mem = method_memory_estimate(method, num_node, F.num_ijw)/1048576.0;
+        if (log_ptr)
+        {
+            *log_ptr << "bmatch auto> method " << method << ": ~" << setprecision(3) << time << " sec, ~" << mem << " MB" << setprecision(6);
+        }
+
+        if (method_accuracy(method)<accuracy)
+        {
+            if (log_ptr)
+                *log_ptr << ", no: guarantees " << method_accuracy(method) << endl;
+            continue;
+        }
+        if (method_needs_bipartite(method) && (!F.is_bipartite))
+        {
+            if (log_ptr)
+                *log_ptr << ", no: graph not bipartite" << endl;
+            continue;
+        }
+        if (method_ignores_lower_bound(method) && F.has_lower_bound)
+        {
+            if (log_ptr)
+                *log_ptr << ", no: lower bounds not guaranteed" << endl;
+            continue;
+        }
+        if (time<fallback_time)
+        {
+            fallback_method = method;
+            fallback_time = time;
+        }
+        if ((max_mem>0) && (mem>max_mem))
+        {
+            if (log_ptr)
+                *log_ptr << ", no: > -max_mem " << max_mem << " MB" << endl;
+            continue;
+        }
+        if (log_ptr)
+            *log_ptr << endl;
+        if (time<best_time)
+        {
+            best_method = method;
+            best_time = time;
+        }
+    }
+
+    if (best_method==0)
+    {
+        best_method = (fallback_method!=0) ? fallback_method : 1;
+        if (log_ptr)
+            *log_ptr << "bmatch auto> no method meets every constraint" << endl;
+    }
+    if (log_ptr)
+    {
+        *log_ptr << "bmatch auto> method " << best_method << endl;
+    }
+    return best_method;
+}
+/* end select_method */
+
@@ -20,9 +20,9 @@ BeliefPropBmatch::
 }
 
 
-/* solve_bmatching_problem */
+/* solve_bmatching_view */
 int BeliefPropBmatch::
-solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
 {
     /* */
     /* ****************** expecting full matrix ******************** */
@@ -36,9 +36,11 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
 
     int     success = 0;
     int     node_cap = in_num_node;
+    int     num_iter = 0;
+    double  num_message = 0.0;
 
     /* local (non-const) copies */
-    DoubleVec   L_ijw_vec = in_ijw_vec;     /* degrees of input graph */
+    DoubleVec   L_ijw_vec;     /* row-major copy of the input */
     DoubleVec   deg_vec(in_num_node, 0);     /* degrees of input graph */
 
     /* adjacency and weights */
@@ -47,9 +49,12 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     SparseVecIterator sp;
 
     /* check for positive wgts */
+    profile.start("preprocess");
+    in_ijw_view.copy(in_num_ijw, L_ijw_vec);
     for (k=0; k<in_num_ijw; k++) {
         if (L_ijw_vec[3*k + 2]<0) {
-            cerr << " bmatch_ijw!> weights must be positive " << endl;
+            solver_log() << " bmatch_ijw!> weights must be positive " << endl;
+            profile.stop("preprocess");
             return 0;
         }
     }
@@ -73,30 +78,37 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     /* debug */
     if (verbose>2)
     {
-        cerr << "ijw_vec:" << endl;
-        write_mn_matrix(cerr, in_num_ijw, 3, L_ijw_vec, 4);
-        cerr << "deg_vec:" << endl;
-        write_mn_matrix(cerr, in_num_node, 1, deg_vec, 4);
-        cerr << "deg_bdd_vec:" << endl;
-        write_mn_matrix(cerr, in_num_node, 2, in_deg_bdd_vec, 4);
+        solver_log() << "ijw_vec:" << endl;
+        write_mn_matrix(solver_log(), in_num_ijw, 3, L_ijw_vec, 4);
+        solver_log() << "deg_vec:" << endl;
+        write_mn_matrix(solver_log(), in_num_node, 1, deg_vec, 4);
+        solver_log() << "deg_bdd_vec:" << endl;
+        write_mn_matrix(solver_log(), in_num_node, 2, in_deg_bdd_vec, 4);
     }
 
 
 
 
+    profile.stop("preprocess");
+
     /********************************************************/
     /* call C code */
     /* */
+    profile.start("solve");
     num_bmatch_edge = node_cap*in_num_node;
     bmatch_edge_vec.clear();
     bmatch_edge_vec.resize(3*num_bmatch_edge, 0.0);
     /* */
-    solve(in_num_ijw, &L_ijw_vec[0], in_num_node, node_cap, &bmatch_edge_vec[0], verbose);
+    solve(in_num_ijw, &L_ijw_vec[0], in_num_node, node_cap, &bmatch_edge_vec[0], verbose, &num_iter, &num_message);
     /* */
+    profile.stop("solve");
+    profile.count("bp_iterations", num_iter);
+    profile.count("bp_messages", num_message);
     /********************************************************/
 
     /* create WWmat */
-    ijw_2_svecvec(in_num_ijw, in_ijw_vec, in_num_node, WWmat);
+    profile.start("weight");
+    ijw_2_svecvec(in_num_ijw, L_ijw_vec, in_num_node, WWmat);
 
 
     /* compute weight and degree (self-loops=2) */
@@ -107,6 +119,7 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
         j = int(bmatch_edge_vec[3*k+1]);
         bmatch_wgt += (*WWmat[i])[j];
     }
+    profile.stop("weight");
 
     /* local cleanup */
     delete_svecvec(AAmat);
@@ -114,7 +127,34 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
 
     return success;
 }
-/* end solve_bmatching_problem */
+/* end solve_bmatching_view */
+
+
+/*
+ * memory estimate, from the allocations of solve() below and the wrapper
+ * above, for m entries of the full matrix:
+ *
+ *   W, n x n doubles                           8 n^2
+ *   2n nodes, each with message[n], and phi[] and neighbors[] of the
+ *     entries of its row or column of W that are > NEG_INF; the entries
+ *     of W not in the ijw are never set, and count, so all n of them
+ *                                             48 n^2
+ *   P and the beliefs of the 2n nodes, b ints per node       12 b n
+ *   the copy of the ijw, and the 3 b n doubles of the output 24 m + 24 b n
+ *   node structs, row pointers and heap chunk headers       ~300 n
+ *
+ * with b n <= m, b being at most the smallest degree; the map of the
+ * weights (~64 bytes per entry) is built once W and the nodes are freed
+ * */
+double BeliefPropBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    double n = double(num_node);
+    double m = double(num_ijw);
+
+    return max(56.0*n*n + 60.0*m + 300.0*n, 112.0*m + 80.0*n);
+}
+/* end memory_estimate */
 
 
 
@@ -266,7 +306,7 @@ int permCheck(node_t **nodes, int**P, int n, int b)
 /*
  * main() from bpbmatch.c
  * */
-int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int node_cap, double * output_edge_ptr, int verbose) 
+int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int node_cap, double * output_edge_ptr, int verbose, int * num_iter, double * num_message) 
 {
     int nnz;
     int num_output_edge;
@@ -287,7 +327,6 @@ int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int n
     node_t **alpha, **beta;
 
 
-    srand(time(NULL));
     n = num_input_node;
     b = node_cap;
 
@@ -374,10 +413,10 @@ int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int n
 
     if (verbose>1)
     {
-        cerr << "Graph allocated, " <<  n;
-        cerr << " nodes, " << links;
-        cerr << " links, " << 100*(double)links/(double)(n*n);
-        cerr << " connectivity" << endl; ;
+        solver_log() << "Graph allocated, " <<  n;
+        solver_log() << " nodes, " << links;
+        solver_log() << " links, " << 100*(double)links/(double)(n*n);
+        solver_log() << " connectivity" << endl; ;
     }
 
     /*********************************************
@@ -400,13 +439,21 @@ int solve(int num_input_edge, double * input_edge_ptr, int num_input_node, int n
         //cerr << "permcheck successful" << endl;
 
         if (++iters>MAX_ITER) {
-            cerr << " beliefprop.solve> Reached maximum iterations without converging" << endl;
+            solver_log() << " beliefprop.solve> Reached maximum iterations without converging" << endl;
             converged=0;
         }
     }
     /*********************************************************************/
     /*********************************************************************/
 
+    /* counters: each iteration updates the messages of every link */
+    if (num_iter!=NULL) {
+        *num_iter = iters;
+    }
+    if (num_message!=NULL) {
+        *num_message = double(iters)*double(links);
+    }
+
     /* number of edges */
     num_output_edge = node_cap*num_input_node;
 
@@ -0,0 +1,706 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ *
+ * benchmark of the methods on the data fixtures and on synthetic graphs
+ *
+ * every case (input, method) runs in a child process, so that its peak
+ * resident memory is its own and a method that crashes or runs past the
+ * time limit does not stop the benchmark
+ * */
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+using namespace std;
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "AbstractBmatchSolver.hpp"
+#include "newsolver.hpp"
+#include "bipartite.hpp"
+#include "synthetic.hpp"
+
+/* number of methods */
+#define BENCH_NUM_METHOD (7)
+
+
+/* a benchmark case, and its measurements */
+class BenchCase
+{
+    public:
+        BenchCase() : fixture(0), kind(0), size(0), b(0), method(0), reorder(0), num_node(0), num_ijw(0), bandwidth(0), success(0), bmatch_wgt(0.0), peak_rss_kb(0.0) {};
+
+        /* input: fixture data/ijw_in_<fixture>.txt, or a synthetic graph
+         * of kind with size nodes and upper bound b */
+        int fixture;
+        int kind;
+        int size;
+        int b;
+
+        /* method 1-7 */
+        int method;
+
+        /* node order, as bmatch -reorder: 0 => input, 1 => by degree,
+         * 2 => Cuthill-McKee, 3 => reverse Cuthill-McKee */
+        int reorder;
+
+        /* measurements, bandwidth max |i-j| in the order solved; success is
+         * -1 if the case was killed */
+        int num_node;
+        int num_ijw;
+        int bandwidth;
+        int success;
+        double bmatch_wgt;
+        DoubleVec sec_vec;
+        double peak_rss_kb;
+};
+
+
+/* comma-separated list of ints, or of names of synthetic graphs */
+static void bench_parse_list(const string & str, const int & is_kind, vector<int> & val_vec)
+{
+    string item;
+    stringstream ss(str);
+
+    val_vec.clear();
+    while (getline(ss, item, ','))
+    {
+        if (item.size()==0)
+        {
+            continue;
+        }
+        if (is_kind)
+        {
+            if (synthetic_kind(item)==0)
+            {
+                cerr << "bmatch_bench!> unknown graph " << item << endl;
+                exit(1);
+            }
+            val_vec.push_back(synthetic_kind(item));
+        }
+        else
+        {
+            val_vec.push_back(atoi(item.c_str()));
+        }
+    }
+}
+/* end bench_parse_list */
+
+
+/* linearly interpolated q-quantile of sec_vec */
+static double bench_quantile(const DoubleVec & sec_vec, const double & q)
+{
+    int k;
+    double r;
+    DoubleVec sorted_vec(sec_vec);
+
+    if (sorted_vec.size()==0)
+    {
+        return 0.0;
+    }
+    sort(sorted_vec.begin(), sorted_vec.end());
+    r = q*double(sorted_vec.size() - 1);
+    k = int(floor(r));
+    if (k + 1>=int(sorted_vec.size()))
+    {
+        return sorted_vec.back();
+    }
+    return sorted_vec[k] + (r - k)*(sorted_vec[k+1] - sorted_vec[k]);
+}
+/* end bench_quantile */
+
+
+/* input of a case; the degree bounds of a fixture are read from
+ * data/degree_in_<fixture>.txt, as an Mx2 or Mx1 matrix */
+static int bench_input(const BenchCase & bc, const string & data_dir, const double & avg_deg, const unsigned int & seed, int & num_node, DoubleVec & deg_bdd_vec, int & num_ijw, DoubleVec & ijw_vec)
+{
+    register int k;
+    int         M;
+    int         N;
+    DoubleVec   mn_vec;
+    ifstream    fin_strm;
+    stringstream ss;
+
+    if (bc.fixture>0)
+    {
+        ss << data_dir << "/ijw_in_" << bc.fixture << ".txt";
+        fin_strm.open(ss.str().c_str());
+        ijw_read_ijw(fin_strm, num_ijw, ijw_vec);
+        fin_strm.close();
+        num_node = 0;
+        for (k=0; k<num_ijw; k++)
+        {
+            num_node = max(num_node, 1 + int(max(ijw_vec[3*k+0], ijw_vec[3*k+1])));
+        }
+        ss.str("");
+        ss << data_dir << "/degree_in_" << bc.fixture << ".txt";
+        fin_strm.open(ss.str().c_str());
+        read_mn_matrix(fin_strm, M, N, mn_vec);
+        fin_strm.close();
+        if ((num_ijw==0) || (M<num_node) || ((N!=1) && (N!=2)))
+        {
+            cerr << "bmatch_bench!> cannot read fixture " << bc.fixture << " in " << data_dir << endl;
+            return 0;
+        }
+        num_node = M;
+        deg_bdd_vec.resize(2*num_node);
+        for (k=0; k<num_node; k++)
+        {
+            deg_bdd_vec[2*k+0] = (N==2) ? mn_vec[2*k+0] : 0.0;
+            deg_bdd_vec[2*k+1] = (N==2) ? mn_vec[2*k+1] : mn_vec[k];
+        }
+        return 1;
+    }
+
+    num_node = bc.size;
+    if (!synthetic_ijw(bc.kind, num_node, avg_deg, seed, num_ijw, ijw_vec))
+    {
+        return 0;
+    }
+    deg_bdd_vec.resize(2*num_node);
+    for (k=0; k<num_node; k++)
+    {
+        deg_bdd_vec[2*k+0] = 0.0;
+        deg_bdd_vec[2*k+1] = bc.b;
+    }
+    return 1;
+}
+/* end bench_input */
+
+
+/* run a case in this (child) process, writing a line "num_node num_ijw
+ * bandwidth" and then a line "success wgt sec" per repetition to out; the
+ * nodes are relabeled as by bmatch -reorder before the solves, which are
+ * timed alone; method 7 is only run on bipartite inputs, with the left
+ * nodes of the synthetic bipartite graphs (those below num_node/2, in the
+ * input order) or else a 2-colouring */
+static void bench_child(const BenchCase & bc, const string & data_dir, const double & avg_deg, const unsigned int & seed, const int & num_repeat, const Parameter & PP, FILE * out)
+{
+    register int r;
+    int         num_node;
+    int         num_ijw;
+    int         num_work_ijw;
+    int         num_bmatch_edge;
+    int         success;
+    double      bmatch_wgt;
+    double      solve_time;
+    DoubleVec   deg_bdd_vec;
+    DoubleVec   ijw_vec;
+    DoubleVec   work_ijw_vec;
+    DoubleVec   bmatch_edge_vec;
+    vector<bool> keep_vec;
+    vector<int> side_vec;
+    vector<int> order_vec;
+    vector<int> label_vec;
+    DoubleVec   L_deg_bdd_vec;
+    AbstractBmatchSolver * ALG;
+    Parameter   CP(PP);
+
+    if (!bench_input(bc, data_dir, avg_deg, seed, num_node, deg_bdd_vec, num_ijw, ijw_vec))
+    {
+        return;
+    }
+    if (bc.method==7)
+    {
+        ijw_upper_tri(num_ijw, ijw_vec, 0);
+        if ((bc.fixture==0) && (bc.kind==SYNTHETIC_BIPARTITE))
+        {
+            CP.bipartite = num_node/2;
+        }
+        keep_vec.assign(num_node, true);
+        BipartiteFlowBmatch::bipartition(num_node, CP.bipartite, num_ijw, ijw_vec, keep_vec, side_vec);
+        if (side_vec.size()==0)
+        {
+            return;
+        }
+    }
+    if (bc.reorder>0)
+    {
+        keep_vec.assign(num_node, true);
+        ijw_keep_upper_tri(num_ijw, ijw_vec, keep_vec);
+        ijw_node_order(num_node, num_ijw, ijw_vec, bc.reorder, order_vec);
+        label_vec.resize(num_node);
+        L_deg_bdd_vec.resize(2*num_node);
+        for (r=0; r<num_node; r++)
+        {
+            label_vec[order_vec[r]] = r;
+            L_deg_bdd_vec[2*r+0] = deg_bdd_vec[2*order_vec[r]+0];
+            L_deg_bdd_vec[2*r+1] = deg_bdd_vec[2*order_vec[r]+1];
+        }
+        deg_bdd_vec.swap(L_deg_bdd_vec);
+        ijw_relabel(num_ijw, ijw_vec, label_vec, 1);
+        /* the left nodes are no longer the first */
+        CP.bipartite = -1;
+    }
+    fprintf(out, "%d %d %d\n", num_node, num_ijw, ijw_bandwidth(num_ijw, ijw_vec));
+    fflush(out);
+
+    for (r=0; r<num_repeat; r++)
+    {
+        num_work_ijw = num_ijw;
+        work_ijw_vec = ijw_vec;
+        if (bc.method==5)
+        {
+            /* use full matrix */
+            ijw_add_upper_tri_transpose(num_work_ijw, work_ijw_vec, 1);
+        }
+        ALG = new_solver(bc.method, CP);
+        ALG->seed = seed;
+        num_bmatch_edge = 0;
+        bmatch_wgt = 0.0;
+        solve_time = wall_clock();
+        success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_work_ijw, work_ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, 0);
+        solve_time = wall_clock() - solve_time;
+        delete ALG;
+        if (bc.method==5) /* special case */
+        {
+            bmatch_wgt = 0.5*bmatch_wgt;
+        }
+        fprintf(out, "%d %.17g %.17g\n", success, bmatch_wgt, solve_time);
+        fflush(out);
+    }
+}
+/* end bench_child */
+
+
+/* run a case in a child process, killed after time_limit seconds
+ * (0 => none); returns 0 if the case does not apply */
+static int bench_run(BenchCase & bc, const string & data_dir, const double & avg_deg, const unsigned int & seed, const int & num_repeat, const Parameter & PP, const int & time_limit, const int & verbose)
+{
+    int         fd[2];
+    int         null_fd;
+    int         status;
+    int         success;
+    double      wgt;
+    double      sec;
+    pid_t       pid;
+    FILE *      in;
+    FILE *      out;
+    struct rusage usage;
+
+    cout.flush();
+    cerr.flush();
+    if (pipe(fd)!=0)
+    {
+        perror("bmatch_bench!> pipe");
+        exit(1);
+    }
+    pid = fork();
+    if (pid<0)
+    {
+        perror("bmatch_bench!> fork");
+        exit(1);
+    }
+    if (pid==0)
+    {
+        /* child: quiet solvers, unless verbose */
+        close(fd[0]);
+        if (verbose<2)
+        {
+            null_fd = open("/dev/null", O_WRONLY);
+            dup2(null_fd, 2);
+        }
+        if (time_limit>0)
+        {
+            alarm(time_limit);
+        }
+        out = fdopen(fd[1], "w");
+        bench_child(bc, data_dir, avg_deg, seed, num_repeat, PP, out);
+        fclose(out);
+        _exit(0);
+    }
+
+    /* parent */
+    close(fd[1]);
+    in = fdopen(fd[0], "r");
+    bc.sec_vec.clear();
+    bc.success = 1;
+    if (fscanf(in, "%d %d %d", &bc.num_node, &bc.num_ijw, &bc.bandwidth)!=3)
+    {
+        bc.success = 0;
+    }
+    while (fscanf(in, "%d %lg %lg", &success, &wgt, &sec)==3)
+    {
+        bc.success = min(bc.success, success);
+        bc.bmatch_wgt = wgt;
+        bc.sec_vec.push_back(sec);
+    }
+    fclose(in);
+    wait4(pid, &status, 0, &usage);
+#ifdef __APPLE__
+    bc.peak_rss_kb = usage.ru_maxrss/1024.0;
+#else
+    bc.peak_rss_kb = usage.ru_maxrss;
+#endif
+    if ((!WIFEXITED(status)) || (WEXITSTATUS(status)!=0))
+    {
+        /* killed, or ran past the time limit */
+        bc.success = -1;
+        return 1;
+    }
+    if (bc.sec_vec.size()==0)
+    {
+        /* unreadable input, or method 7 on a graph that is not bipartite */
+        return 0;
+    }
+    return 1;
+}
+/* end bench_run */
+
+
+/* write the header of the CSV output */
+static void bench_write_csv_header(ostream & out)
+{
+    out << "tag,input,num_node,num_ijw,b,method,reorder,bandwidth,success,repeat,wgt,median_sec,p95_sec,edges_per_sec,peak_rss_kb" << endl;
+}
+/* end bench_write_csv_header */
+
+
+/* name of the input of a case */
+static string bench_input_name(const BenchCase & bc)
+{
+    stringstream ss;
+    if (bc.fixture>0)
+    {
+        ss << "ijw_in_" << bc.fixture;
+    }
+    else
+    {
+        ss << synthetic_name(bc.kind);
+    }
+    return ss.str();
+}
+/* end bench_input_name */
+
+
+/* write a case as a CSV row, or as a JSON object */
+static void bench_write_case(ostream & out, const string & tag, const BenchCase & bc, const int & is_json)
+{
+    double median_sec;
+    double p95_sec;
+    double edges_per_sec;
+
+    median_sec = bench_quantile(bc.sec_vec, 0.5);
+    p95_sec = bench_quantile(bc.sec_vec, 0.95);
+    edges_per_sec = (median_sec>0) ? bc.num_ijw/median_sec : 0.0;
+    if (is_json)
+    {
+        out << "{\"tag\": ";
+        write_json_string(out, tag);
+        out << ", \"input\": ";
+        write_json_string(out, bench_input_name(bc));
+        out << ", \"num_node\": " << bc.num_node;
+        out << ", \"num_ijw\": " << bc.num_ijw;
+        out << ", \"b\": ";
+        if (bc.fixture>0)
+        {
+            out << "null";
+        }
+        else
+        {
+            out << bc.b;
+        }
+        out << ", \"method\": " << bc.method;
+        out << ", \"reorder\": " << bc.reorder;
+        out << ", \"bandwidth\": " << bc.bandwidth;
+        out << ", \"success\": " << bc.success;
+        out << ", \"repeat\": " << bc.sec_vec.size();
+        out << ", \"wgt\": " << bc.bmatch_wgt;
+        out << ", \"median_sec\": " << median_sec;
+        out << ", \"p95_sec\": " << p95_sec;
+        out << ", \"edges_per_sec\": " << edges_per_sec;
+        out << ", \"peak_rss_kb\": " << bc.peak_rss_kb << "}";
+        return;
+    }
+    out << tag << "," << bench_input_name(bc) << "," << bc.num_node << "," << bc.num_ijw << ",";
+    if (bc.fixture==0)
+    {
+        out << bc.b;
+    }
+    out << "," << bc.method << "," << bc.reorder << "," << bc.bandwidth << ",";
+    out << bc.success << "," << bc.sec_vec.size() << ",";
+    out << bc.bmatch_wgt << "," << median_sec << "," << p95_sec << ",";
+    out << edges_per_sec << "," << bc.peak_rss_kb << endl;
+}
+/* end bench_write_case */
+
+
+/* */
+static void bench_print_help()
+{
+    cerr << "usage: bmatch_bench [options]" << endl;
+    cerr << endl;
+    cerr << "Runs each method on the data fixtures and on synthetic graphs, and writes" << endl;
+    cerr << "the median and 95th percentile of the solve time, the edges per second," << endl;
+    cerr << "the peak resident memory and the weight of each case, as CSV or JSON." << endl;
+    cerr << endl;
+    cerr << "Arguments [with default values]:" << endl;
+    cerr << "    -methods    [1,2,3,4,5,6,7           ] methods to run" << endl;
+    cerr << "    -data       [data                    ] directory of the fixtures, NULL => none" << endl;
+    cerr << "    -fixtures   [1,2,3,4,5               ] fixtures ijw_in_<k>.txt / degree_in_<k>.txt" << endl;
+    cerr << "    -graphs     [random,powerlaw,block,dense,bipartite] synthetic graphs, or knn" << endl;
+    cerr << "    -sizes      [200,1000                ] nodes of the synthetic graphs" << endl;
+    cerr << "    -deg        [8                       ] average degree of the synthetic graphs" << endl;
+    cerr << "    -b          [1,4                     ] upper bounds of the synthetic graphs" << endl;
+    cerr << "    -repeat     [5                       ] runs of each case" << endl;
+    cerr << "    -seed       [1                       ] seed of the graphs and the methods" << endl;
+    cerr << "    -threads    [0                       ] threads of method 6, 0 => all cores" << endl;
+    cerr << "    -prune      [0                       ] prune dominated edges before method 1" << endl;
+    cerr << "    -queue      [-1                      ] goblin heap of methods 1-2, as in bmatch" << endl;
+    cerr << "    -primal_dual [-1                     ] goblin methPrimalDual of methods 1-2" << endl;
+    cerr << "    -reorder    [0                       ] node orders of each case, as bmatch -reorder" << endl;
+    cerr << "    -time_limit [60                      ] seconds of each case, 0 => none" << endl;
+    cerr << "    -format     [csv                     ] csv or json" << endl;
+    cerr << "    -tag        [                        ] label of the run, e.g. the version" << endl;
+    cerr << "    -output     [NULL                    ] output file, NULL => stdout" << endl;
+    cerr << "    -verbose    [1                       ] 0 => quiet, 2 => show the solvers" << endl;
+    cerr << endl;
+    cerr << "Method 7 is only run on bipartite inputs.  The solvers are set up as in" << endl;
+    cerr << "bmatch, by the options above.  With -reorder 0,1,2,3 each case is run in" << endl;
+    cerr << "each node order, the relabeling untimed, and its bandwidth max |i-j| is" << endl;
+    cerr << "reported with the solve time." << endl;
+    exit(1);
+}
+/* end bench_print_help */
+
+
+/* */
+int main(int argc, char *argv[])
+{
+    register int i;
+    register int k;
+    register int s;
+    register int m;
+    register int r;
+    int         num_case;
+    int         is_first;
+    int         num_repeat = 5;
+    int         time_limit = 60;
+    int         verbose = 1;
+    int         is_json = 0;
+    double      avg_deg = 8.0;
+    unsigned int seed = 1;
+    string      data_dir("data");
+    string      tag("");
+    string      output("NULL");
+    vector<int> method_vec;
+    vector<int> fixture_vec;
+    vector<int> kind_vec;
+    vector<int> size_vec;
+    vector<int> b_vec;
+    vector<int> reorder_vec;
+    vector<BenchCase> case_vec;
+    BenchCase   bc;
+    ofstream    fout_strm;
+    ostream *   out_strm_ptr;
+    Parameter   PP;
+
+    bench_parse_list("1,2,3,4,5,6,7", 0, method_vec);
+    bench_parse_list("1,2,3,4,5", 0, fixture_vec);
+    bench_parse_list("random,powerlaw,block,dense,bipartite", 1, kind_vec);
+    bench_parse_list("200,1000", 0, size_vec);
+    bench_parse_list("1,4", 0, b_vec);
+    bench_parse_list("0", 0, reorder_vec);
+
+    /* parse cmd line */
+    for (i=1; i<argc; i++)
+    {
+        if ((string("-h")==argv[i]) || (string("-help")==argv[i]) || (i+1>=argc))
+        {
+            bench_print_help();
+        }
+        if (string("-methods")==argv[i]) {
+            bench_parse_list(argv[++i], 0, method_vec); continue;
+        }
+        if (string("-data")==argv[i]) {
+            data_dir = string(argv[++i]); continue;
+        }
+        if (string("-fixtures")==argv[i]) {
+            bench_parse_list(argv[++i], 0, fixture_vec); continue;
+        }
+        if (string("-graphs")==argv[i]) {
+            bench_parse_list(argv[++i], 1, kind_vec); continue;
+        }
+        if (string("-sizes")==argv[i]) {
+            bench_parse_list(argv[++i], 0, size_vec); continue;
+        }
+        if (string("-deg")==argv[i]) {
+            avg_deg = atof(argv[++i]); continue;
+        }
+        if (string("-b")==argv[i]) {
+            bench_parse_list(argv[++i], 0, b_vec); continue;
+        }
+        if (string("-repeat")==argv[i]) {
+            num_repeat = max(1, atoi(argv[++i])); continue;
+        }
+        if (string("-seed")==argv[i]) {
+            seed = (unsigned int)(atoi(argv[++i])); continue;
+        }
+        if (string("-threads")==argv[i]) {
+            PP.threads = atoi(argv[++i]); continue;
+        }
+        if (string("-prune")==argv[i]) {
+            PP.prune = atoi(argv[++i]); continue;
+        }
+        if (string("-queue")==argv[i]) {
+            PP.queue = atoi(argv[++i]); continue;
+        }
+        if (string("-primal_dual")==argv[i]) {
+            PP.primal_dual = atoi(argv[++i]); continue;
+        }
+        if (string("-reorder")==argv[i]) {
+            bench_parse_list(argv[++i], 0, reorder_vec); continue;
+        }
+        if (string("-time_limit")==argv[i]) {
+            time_limit = atoi(argv[++i]); continue;
+        }
+        if (string("-format")==argv[i]) {
+            is_json = (string("json")==argv[++i]); continue;
+        }
+        if (string("-tag")==argv[i]) {
+            tag = string(argv[++i]); continue;
+        }
+        if (string("-output")==argv[i]) {
+            output = string(argv[++i]); continue;
+        }
+        if (string("-verbose")==argv[i]) {
+            verbose = atoi(argv[++i]); continue;
+        }
+        cerr << "bmatch_bench!> unrecognized option " << argv[i] << endl;
+        bench_print_help();
+    }
+
+    /* cases: fixtures first, then the synthetic graphs */
+    if (data_dir.find("NULL", 0)!=string::npos)
+    {
+        fixture_vec.clear();
+    }
+    for (k=0; k<int(fixture_vec.size()); k++)
+    {
+        for (m=0; m<int(method_vec.size()); m++)
+        {
+            for (r=0; r<int(reorder_vec.size()); r++)
+            {
+                bc = BenchCase();
+                bc.fixture = fixture_vec[k];
+                bc.method = method_vec[m];
+                bc.reorder = reorder_vec[r];
+                case_vec.push_back(bc);
+            }
+        }
+    }
+    for (k=0; k<int(kind_vec.size()); k++)
+    {
+        for (s=0; s<int(size_vec.size()); s++)
+        {
+            for (i=0; i<int(b_vec.size()); i++)
+            {
+                for (m=0; m<int(method_vec.size()); m++)
+                {
+                    for (r=0; r<int(reorder_vec.size()); r++)
+                    {
+                        bc = BenchCase();
+                        bc.kind = kind_vec[k];
+                        bc.size = size_vec[s];
+                        bc.b = b_vec[i];
+                        bc.method = method_vec[m];
+                        bc.reorder = reorder_vec[r];
+                        case_vec.push_back(bc);
+                    }
+                }
+            }
+        }
+    }
+    for (m=0; m<int(method_vec.size()); m++)
+    {
+        if ((method_vec[m]<1) || (method_vec[m]>BENCH_NUM_METHOD))
+        {
+            cerr << "bmatch_bench!> method not recognized " << method_vec[m] << endl;
+            exit(1);
+        }
+    }
+    for (r=0; r<int(reorder_vec.size()); r++)
+    {
+        if ((reorder_vec[r]<0) || (reorder_vec[r]>3))
+        {
+            cerr << "bmatch_bench!> reorder not recognized " << reorder_vec[r] << endl;
+            exit(1);
+        }
+    }
+
+    /* redirect */
+    if (output.find("NULL", 0)!=string::npos)
+    {
+        out_strm_ptr = &cout;
+    }
+    else
+    {
+        fout_strm.open(output.c_str());
+        out_strm_ptr = &fout_strm;
+    }
+    out_strm_ptr->precision(12);
+    if (is_json)
+    {
+        *out_strm_ptr << "[" << endl;
+    }
+    else
+    {
+        bench_write_csv_header(*out_strm_ptr);
+    }
+
+    /* run */
+    num_case = 0;
+    is_first = 1;
+    for (k=0; k<int(case_vec.size()); k++)
+    {
+        if (verbose>0)
+        {
+            cerr << "bmatch_bench> " << bench_input_name(case_vec[k]);
+            if (case_vec[k].fixture==0)
+            {
+                cerr << " n=" << case_vec[k].size << " b=" << case_vec[k].b;
+            }
+            cerr << " method " << case_vec[k].method;
+            if (case_vec[k].reorder>0)
+            {
+                cerr << " reorder " << case_vec[k].reorder;
+            }
+            cerr << " ..." << endl;
+        }
+        if (!bench_run(case_vec[k], data_dir, avg_deg, seed, num_repeat, PP, time_limit, verbose))
+        {
+            continue;
+        }
+        if (is_json && (!is_first))
+        {
+            *out_strm_ptr << "," << endl;
+        }
+        bench_write_case(*out_strm_ptr, tag, case_vec[k], is_json);
+        out_strm_ptr->flush();
+        is_first = 0;
+        num_case += 1;
+    }
+    if (is_json)
+    {
+        *out_strm_ptr << endl << "]" << endl;
+    }
+    if (output.find("NULL", 0)==string::npos)
+    {
+        fout_strm.close();
+    }
+    if (verbose>0)
+    {
+        cerr << "bmatch_bench> " << num_case << " cases" << endl;
+    }
+    return 0;
+}
+/* end main */
+
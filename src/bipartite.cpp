@@ -0,0 +1,493 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <cmath>
+#include <queue>
+#include <functional>
+#include "bipartite.hpp"
+
+
+/* destructor */
+BipartiteFlowBmatch::
+~BipartiteFlowBmatch()
+{
+    //cerr << "BipartiteFlowBmatch destructor> " << endl;
+    num_node = 0;
+    num_ijw = 0;
+}
+
+
+/* memory estimate: per edge, the local copy of the ijw (24), the edge
+ * arrays (12), an arc and its reverse with their adjacency entries (48),
+ * grown by push_back, and the b-matching (24); per node, two arcs to t,
+ * the supplies, potentials, distances and heap */
+double BipartiteFlowBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return 128.0*double(num_ijw) + 160.0*double(num_node);
+}
+/* end memory_estimate */
+
+
+/* sides of the nodes of an upper triangle ijw, see bipartite.hpp */
+void BipartiteFlowBmatch::
+bipartition(const int & num_node, const int & num_left, const int & num_ijw, const DoubleVec & ijw_vec, const vector<bool> & keep_vec, vector<int> & side_vec)
+{
+    register int i;
+    register int j;
+    register int k;
+    int head;
+    vector<int> row_begin_vec(num_node+1, 0);
+    vector<int> row_end_vec;
+    vector<int> row_nbr_vec;
+    vector<int> queue_vec;
+
+    side_vec.assign(num_node, 0);
+    if (num_left>=0)
+    {
+        for (i=num_left; i<num_node; i++)
+        {
+            side_vec[i] = 1;
+        }
+    }
+    else
+    {
+        /* 2-colouring, breadth-first */
+        for (k=0; k<num_ijw; k++)
+        {
+            i = int(ijw_vec[3*k+0]);
+            j = int(ijw_vec[3*k+1]);
+            if (keep_vec[i] && keep_vec[j])
+            {
+                row_begin_vec[i+1] += 1;
+                row_begin_vec[j+1] += 1;
+            }
+        }
+        for (i=0; i<num_node; i++)
+        {
+            row_begin_vec[i+1] += row_begin_vec[i];
+        }
+        row_nbr_vec.resize(row_begin_vec[num_node]);
+        row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+        for (k=0; k<num_ijw; k++)
+        {
+            i = int(ijw_vec[3*k+0]);
+            j = int(ijw_vec[3*k+1]);
+            if (keep_vec[i] && keep_vec[j])
+            {
+                row_nbr_vec[row_end_vec[i]++] = j;
+                row_nbr_vec[row_end_vec[j]++] = i;
+            }
+        }
+        side_vec.assign(num_node, -1);
+        queue_vec.reserve(num_node);
+        for (k=0; k<num_node; k++)
+        {
+            if (side_vec[k]>=0)
+            {
+                continue;
+            }
+            side_vec[k] = 0;
+            queue_vec.push_back(k);
+            for (head=int(queue_vec.size())-1; head<int(queue_vec.size()); head++)
+            {
+                i = queue_vec[head];
+                for (j=row_begin_vec[i]; j<row_begin_vec[i+1]; j++)
+                {
+                    if (side_vec[row_nbr_vec[j]]<0)
+                    {
+                        side_vec[row_nbr_vec[j]] = 1 - side_vec[i];
+                        queue_vec.push_back(row_nbr_vec[j]);
+                    }
+                }
+            }
+        }
+    }
+
+    /* no edge within a side */
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        if (keep_vec[i] && keep_vec[j] && (side_vec[i]==side_vec[j]))
+        {
+            side_vec.clear();
+            return;
+        }
+    }
+}
+/* end bipartition */
+
+
+/* bipartition the graph, then solve as usual */
+int BipartiteFlowBmatch::
+solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+{
+    register int i;
+    int L_num_ijw = 0;
+    DoubleVec L_ijw_vec;
+    vector<bool> keep_vec(in_num_node, true);
+
+    /* the graph of BmatchSolver::solve_bmatching_view */
+    profile.start("preprocess");
+    for (i=0; i<in_num_node; i++)
+    {
+        keep_vec[i] = (in_deg_bdd_vec[2*i+1]!=0);
+    }
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, L_num_ijw, L_ijw_vec);
+    bipartition(in_num_node, num_left, L_num_ijw, L_ijw_vec, keep_vec, side_vec);
+    profile.stop("preprocess");
+    if (side_vec.size()==0)
+    {
+        solver_log() << " BipartiteFlowBmatch!> the graph is not bipartite";
+        solver_log() << ((num_left>=0) ? " with the given left nodes" : "") << endl;
+        num_bmatch_edge = 0;
+        bmatch_edge_vec.clear();
+        bmatch_wgt = 0.0;
+        return 0;
+    }
+
+    return BmatchSolver::solve_bmatching_view(in_num_node, in_deg_bdd_vec, in_num_ijw, in_ijw_view, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+}
+/* end solve_bmatching_view */
+
+
+/* print memory */
+void BipartiteFlowBmatch::
+print(const int & print_what)
+{
+    register int x;
+    register int k;
+    int a;
+
+    if (verbose==0)
+    {
+        return;
+    }
+
+    /* network, or its flow */
+    solver_log() << ((print_what==0) ? "Network>" : "Flow>") << endl;
+    for (x=0; x<num_node+1; x++)
+    {
+        solver_log() << "  i=" << x;
+        solver_log() << ((x==num_node) ? " (t)" : ((side_vec[x]==0) ? " (L)" : " (R)"));
+        solver_log() << "  j:cap:cost=[";
+        for (k=row_begin_vec[x]; (k<row_begin_vec[x+1]) && (k<row_begin_vec[x]+50); k++)
+        {
+            a = row_arc_vec[k];
+            if (a%2==0)
+            {
+                solver_log() << " " << arc_head_vec[a];
+                solver_log() << ":" << ((print_what==0) ? arc_cap_vec[a] + arc_cap_vec[a+1] : arc_cap_vec[a+1]);
+                solver_log() << ":" << arc_cost_vec[a] << " ";
+            }
+        }
+        if (k<row_begin_vec[x+1])   solver_log() << "... ";
+        solver_log() << "]" << endl;
+    }
+}
+/* end print */
+
+
+/* add the arc u->v and its reverse */
+void BipartiteFlowBmatch::
+add_arc(const int & u, const int & v, const int & cap, const double & cost)
+{
+    arc_tail_vec.push_back(u);
+    arc_head_vec.push_back(v);
+    arc_cap_vec.push_back(cap);
+    arc_cost_vec.push_back(cost);
+    arc_tail_vec.push_back(v);
+    arc_head_vec.push_back(u);
+    arc_cap_vec.push_back(0);
+    arc_cost_vec.push_back(-cost);
+}
+/* end add_arc */
+
+
+/* initialize assuming 0-based indices for nodes */
+void BipartiteFlowBmatch::
+init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & ijw_vec)
+{
+    register int u;
+    register int v;
+    register int e;
+    int t;
+    int lb;
+    int ub;
+    double big;
+    vector<int> row_end_vec;
+
+    verbose = in_verbose;
+    num_node = in_num_node;
+    num_ijw = in_num_ijw;
+    t = num_node;
+
+    /* unmet lower bounds cost more than any path of the edges */
+    big = 1.0;
+    for (e=0; e<num_ijw; e++)
+    {
+        big += 2.0*ijw_vec[3*e + 2];
+    }
+
+    /* arcs of the left nodes to t, the edges and the right nodes to t, in
+     * this order; the left arcs take the units of a left node that it does
+     * not match, those of its lower bound at a cost of big */
+    arc_tail_vec.clear();
+    arc_head_vec.clear();
+    arc_cap_vec.clear();
+    arc_cost_vec.clear();
+    lb_arc_vec.clear();
+    supply_vec.assign(num_node, 0);
+    for (u=0; u<num_node; u++)
+    {
+        /* N.B. index both columns of deg_bdd_vec */
+        lb = int(deg_bdd_vec[2*u+0]);
+        ub = int(deg_bdd_vec[2*u+1]);
+        if (side_vec[u]==0)
+        {
+            supply_vec[u] = ub;
+            if (lb>0)
+            {
+                /* the reverse arc, whose capacity is the deficit */
+                lb_arc_vec.push_back(int(arc_tail_vec.size()) + 1);
+                add_arc(u, t, lb, big);
+            }
+            if (ub>lb)      add_arc(u, t, ub - lb, 0.0);
+        }
+    }
+    edge_u_vec.resize(num_ijw);
+    edge_v_vec.resize(num_ijw);
+    edge_arc_vec.resize(num_ijw);
+    for (e=0; e<num_ijw; e++)
+    {
+        u = int(ijw_vec[3*e + 0]);
+        v = int(ijw_vec[3*e + 1]);
+        edge_u_vec[e] = u;
+        edge_v_vec[e] = v;
+        edge_arc_vec[e] = int(arc_tail_vec.size());
+        if (side_vec[u]==0)
+        {
+            add_arc(u, v, 1, -ijw_vec[3*e + 2]);
+        }
+        else
+        {
+            add_arc(v, u, 1, -ijw_vec[3*e + 2]);
+        }
+    }
+    for (v=0; v<num_node; v++)
+    {
+        lb = int(deg_bdd_vec[2*v+0]);
+        ub = int(deg_bdd_vec[2*v+1]);
+        if (side_vec[v]==1)
+        {
+            if (lb>0)
+            {
+                lb_arc_vec.push_back(int(arc_tail_vec.size()));
+                add_arc(v, t, lb, -big);
+            }
+            if (ub>lb)      add_arc(v, t, ub - lb, 0.0);
+        }
+    }
+
+    /* arcs out of each node */
+    row_begin_vec.assign(num_node+2, 0);
+    for (e=0; e<int(arc_tail_vec.size()); e++)
+    {
+        row_begin_vec[arc_tail_vec[e]+1] += 1;
+    }
+    for (u=0; u<num_node+1; u++)
+    {
+        row_begin_vec[u+1] += row_begin_vec[u];
+    }
+    row_arc_vec.resize(arc_tail_vec.size());
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node + 1);
+    for (e=0; e<int(arc_tail_vec.size()); e++)
+    {
+        row_arc_vec[row_end_vec[arc_tail_vec[e]]++] = e;
+    }
+
+    B_match.clear();
+    print(0);
+}
+/* end init */
+
+
+/*
+ * solve, by successive shortest paths from the left nodes in turn, as the
+ * Hungarian method: Dijkstra on reduced costs from a left node with units
+ * left, stopped once t is settled, and the augmentation of its path
+ *
+ * the potentials of the nodes not settled are kept, and those settled
+ * lowered by dist(t) - dist(x), which keeps the reduced costs non-negative
+ * (the usual update, less dist(t) throughout); a search, and its update,
+ * then only touch the nodes closer than t, which are few once the
+ * potentials are near the duals
+ * */
+int BipartiteFlowBmatch::
+solve()
+{
+    register int x;
+    register int k;
+    register int a;
+    int y;
+    int u;
+    int t;
+    int flow;
+    int deficit;
+    int num_aug;
+    int num_settle;
+    double d;
+    double dist_t;
+    DoubleVec pot_vec;
+    DoubleVec dist_vec;
+    vector<int> pred_vec;
+    vector<char> done_vec;
+    vector<int> touch_vec;
+    priority_queue<pair<double,int>, vector<pair<double,int> >, greater<pair<double,int> > > heap;
+
+    t = num_node;
+
+    /* potentials: shortest distances from all nodes at 0, in arc order */
+    pot_vec.assign(num_node+1, 0.0);
+    for (a=0; a<int(arc_tail_vec.size()); a+=2)
+    {
+        pot_vec[arc_head_vec[a]] = min(pot_vec[arc_head_vec[a]], pot_vec[arc_tail_vec[a]] + arc_cost_vec[a]);
+    }
+
+    num_aug = 0;
+    num_settle = 0;
+    dist_vec.assign(num_node+1, HUGE_VAL);
+    pred_vec.assign(num_node+1, -1);
+    done_vec.assign(num_node+1, 0);
+    for (u=0; u<num_node; u++)
+    {
+        while (supply_vec[u]>0)
+        {
+            /* Dijkstra on reduced costs, from u up to t */
+            while (!heap.empty())
+            {
+                heap.pop();
+            }
+            dist_vec[u] = 0.0;
+            touch_vec.push_back(u);
+            heap.push(make_pair(0.0, u));
+            while (!heap.empty())
+            {
+                x = heap.top().second;
+                heap.pop();
+                if (done_vec[x])
+                {
+                    continue;
+                }
+                done_vec[x] = 1;
+                num_settle += 1;
+                if (x==t)
+                {
+                    break;
+                }
+                for (k=row_begin_vec[x]; k<row_begin_vec[x+1]; k++)
+                {
+                    a = row_arc_vec[k];
+                    y = arc_head_vec[a];
+                    if ((arc_cap_vec[a]==0) || done_vec[y])
+                    {
+                        continue;
+                    }
+                    d = dist_vec[x] + max(0.0, arc_cost_vec[a] + pot_vec[x] - pot_vec[y]);
+                    if (d<dist_vec[y])
+                    {
+                        if (dist_vec[y]==HUGE_VAL)
+                        {
+                            touch_vec.push_back(y);
+                        }
+                        dist_vec[y] = d;
+                        pred_vec[y] = a;
+                        heap.push(make_pair(d, y));
+                    }
+                }
+            }
+
+            /* augment along the path; u always reaches t by its own arcs */
+            flow = supply_vec[u];
+            for (x=t; x!=u; x=arc_tail_vec[pred_vec[x]])
+            {
+                flow = min(flow, arc_cap_vec[pred_vec[x]]);
+            }
+            for (x=t; x!=u; x=arc_tail_vec[pred_vec[x]])
+            {
+                arc_cap_vec[pred_vec[x]] -= flow;
+                arc_cap_vec[pred_vec[x]^1] += flow;
+            }
+            supply_vec[u] -= flow;
+            num_aug += 1;
+
+            /* new potentials of the settled nodes, and a clean slate */
+            dist_t = dist_vec[t];
+            for (k=0; k<int(touch_vec.size()); k++)
+            {
+                x = touch_vec[k];
+                if (done_vec[x])
+                {
+                    pot_vec[x] += dist_vec[x] - dist_t;
+                }
+                dist_vec[x] = HUGE_VAL;
+                pred_vec[x] = -1;
+                done_vec[x] = 0;
+            }
+            touch_vec.clear();
+        }
+    }
+    print(1);
+    profile.count("augmentations", num_aug);
+    profile.count("settled_nodes", num_settle);
+
+    if (verbose>0)
+    {
+        solver_log() << " BipartiteFlowBmatch> augmentations=" << num_aug << " settled=" << num_settle << endl;
+    }
+
+    /* lower bounds not met */
+    deficit = 0;
+    for (k=0; k<int(lb_arc_vec.size()); k++)
+    {
+        deficit += arc_cap_vec[lb_arc_vec[k]];
+    }
+    if (deficit>0)
+    {
+        solver_log() << " BipartiteFlowBmatch!> lower bounds not met, total deficit " << deficit << endl;
+        return -1;
+    }
+
+    /* matched edges */
+    B_match.clear();
+    for (k=0; k<num_ijw; k++)
+    {
+        if (arc_cap_vec[edge_arc_vec[k]]==0)
+        {
+            B_match.push_back(k);
+        }
+    }
+    return B_match.size();
+}
+/* end solve */
+
+
+/* copy b-matching solution using 0-based indices for nodes */
+void BipartiteFlowBmatch::
+solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec)
+{
+    register int k;
+
+    bmatch_edge_vec.clear();
+    bmatch_edge_vec.reserve(3*num_bmatch_edge);
+    for (k=0; k<int(B_match.size()); k++)
+    {
+        bmatch_edge_vec.push_back(edge_u_vec[B_match[k]]);
+        bmatch_edge_vec.push_back(edge_v_vec[B_match[k]]);
+        bmatch_edge_vec.push_back(1.0);
+    }
+}
+/* end solution */
+
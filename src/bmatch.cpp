@@ -19,6 +19,14 @@ using namespace std;
 #include "greedyapprox.hpp"
 #include "goblinexact.hpp"
 #include "beliefprop.hpp"
+#include "bsuitor.hpp"
+#include "bipartite.hpp"
+#include "augmentimprove.hpp"
+#include "streambmatch.hpp"
+#include "bmatch_server.hpp"
+#include "autoselect.hpp"
+#include "newsolver.hpp"
+#include "verifybmatch.hpp"
 
 
 
@@ -110,6 +118,274 @@ void read_degrees(istream & in, int & num_node, DoubleVec & deg_bdd_vec)
 
 
 
+/* solve the same problem with each goblin priority queue and report 
+ * wall-clock time and weight of each */
+void benchmark_goblin_queues(const Parameter & PP, const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const DoubleVec & ijw_vec, const int & verbose)
+{
+    int         pq;
+    int         success;
+    int         num_bmatch_edge;
+    DoubleVec   bmatch_edge_vec;
+    double      bmatch_wgt;
+    double      solve_time;
+    const char * pq_name[] = {"basic", "binary", "fibonacci"};
+
+    AbstractBmatchSolver * ALG;
+    Parameter   QP(PP);
+
+    cerr << "bmatch> goblin priority queue benchmark" << endl;
+    cerr << setw(12) << "queue" << setw(12) << "success" << setw(12) << "edges";
+    cerr << setw(16) << "wgt" << setw(12) << "init" << setw(12) << "solve" << setw(12) << "total" << endl;
+    for (pq=GOBLIN_PQ_BASIC; pq<=GOBLIN_PQ_FIBONACCI; pq++)
+    {
+        QP.queue = pq;
+        ALG = new_solver(PP.method, QP);
+        num_bmatch_edge = 0;
+        bmatch_wgt = 0.0;
+        solve_time = wall_clock();
+        success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, max(verbose-1,0));
+        solve_time = wall_clock() - solve_time;
+        cerr << setw(12) << pq_name[pq] << setw(12) << success << setw(12) << num_bmatch_edge;
+        cerr << setw(16) << bmatch_wgt;
+        cerr << setw(12) << ALG->profile.phase_time("init");
+        cerr << setw(12) << ALG->profile.phase_time("solve");
+        cerr << setw(12) << solve_time << endl;
+        delete ALG;
+    }
+}
+/* end benchmark_goblin_queues */
+
+
+/* keep the ceil(topk * u_i) heaviest edges of each node i, of an upper
+ * triangle ijw without the edges of nodes with u_i = 0 */
+void keep_topk(const int & num_node, const DoubleVec & deg_bdd_vec, const double & topk, int & num_ijw, DoubleVec & ijw_vec)
+{
+    register int k;
+    vector<bool> keep_vec(num_node);
+    vector<int> topk_vec(num_node);
+
+    for (k=0; k<num_node; k++)
+    {
+        keep_vec[k] = (deg_bdd_vec[2*k+1]!=0);
+        topk_vec[k] = int(ceil(topk*max(deg_bdd_vec[2*k+1], 0.0)));
+    }
+    ijw_keep_upper_tri(num_ijw, ijw_vec, keep_vec);
+    ijw_keep_topk(num_ijw, ijw_vec, num_node, topk_vec);
+}
+/* end keep_topk */
+
+
+/*
+ * fit the solve of ALG in PP.max_mem megabytes: while the memory estimate
+ * exceeds the budget, fall back from the maxwgt exact methods and BP
+ * (which needs the full matrix, 2 * num_ijw entries) to the b-suitor
+ * method 6, or to the greedy method 3, whose repair tries to meet them, if
+ * some lower bound is positive; and then keep the ceil(t * u_i) heaviest
+ * edges of each node i for t = 8, 4, 2, 1, in place
+ *
+ * the mincost method 2 has no lighter engine of its objective, nor are
+ * its edges the heaviest, so it is never replaced
+ *
+ * returns the solver to use, with PP.method updated, or NULL if even the
+ * sparsest graph does not fit
+ * */
+AbstractBmatchSolver * fit_memory_budget(AbstractBmatchSolver * ALG, Parameter & PP, const int & num_node, const DoubleVec & deg_bdd_vec, int & num_ijw, DoubleVec & ijw_vec, SolveProfile & run_profile)
+{
+    register int i;
+    double  budget = 1048576.0*PP.max_mem;
+    double  estimate;
+    double  topk;
+    double  kept_topk = 0.0;
+    int     num_full_ijw = num_ijw;
+
+    estimate = ALG->memory_estimate(num_node, (PP.method==5) ? 2*num_ijw : num_ijw);
+    run_profile.count("mem_estimate_in_mb", estimate/1048576.0);
+    if (estimate<=budget)
+    {
+        run_profile.count("mem_estimate_mb", estimate/1048576.0);
+        return ALG;
+    }
+
+    /* no other engine of the mincost objective */
+    if (PP.method==2)
+    {
+        cerr << "bmatch> method 2 (mincost) needs about " << estimate/1048576.0 << " MB";
+        cerr << " > -max_mem " << PP.max_mem << ", and has no fallback" << endl;
+        run_profile.count("mem_method", PP.method);
+        run_profile.count("mem_estimate_mb", estimate/1048576.0);
+        delete ALG;
+        return NULL;
+    }
+
+    /* lighter engine, one that tries to meet the lower bounds if any */
+    if ((PP.method!=3) && (PP.method!=4) && (PP.method!=6))
+    {
+        for (i=0; (i<num_node) && (deg_bdd_vec[2*i]<=0); i++)
+        {
+        }
+        cerr << "bmatch> method " << PP.method << " needs about " << estimate/1048576.0 << " MB";
+        cerr << " > -max_mem " << PP.max_mem << ", falling back to method " << ((i<num_node) ? 3 : 6) << endl;
+        delete ALG;
+        PP.method = (i<num_node) ? 3 : 6;
+        ALG = new_solver(PP.method, PP);
+        estimate = ALG->memory_estimate(num_node, num_ijw);
+    }
+
+    /* sparsification */
+    for (topk=8.0; (estimate>budget) && (topk>=1.0); topk=0.5*topk)
+    {
+        keep_topk(num_node, deg_bdd_vec, topk, num_ijw, ijw_vec);
+        kept_topk = topk;
+        estimate = ALG->memory_estimate(num_node, num_ijw);
+        cerr << "bmatch> -max_mem: top-k " << topk << " kept " << num_ijw << " of " << num_full_ijw;
+        cerr << " edges, about " << estimate/1048576.0 << " MB" << endl;
+    }
+    run_profile.count("mem_method", PP.method);
+    run_profile.count("mem_topk", kept_topk);
+    run_profile.count("mem_estimate_mb", estimate/1048576.0);
+    if (estimate>budget)
+    {
+        delete ALG;
+        return NULL;
+    }
+    return ALG;
+}
+/* end fit_memory_budget */
+
+
+
+/* semi-streaming b-matching of the IJW weights of PP, see StreamBmatch;
+ * the degrees are a constant (-u) or a file of one or two columns, read
+ * before the weights, and the edges are never held in memory */
+int stream_bmatch(Parameter & PP)
+{
+    register int i;
+    int         M;
+    int         N;
+    int         success;
+    int         num_node;
+    int         num_bmatch_edge;
+    double      num_entry;
+    double      bmatch_wgt;
+    double      solve_time;
+    DoubleVec   deg_bdd_vec;
+    DoubleVec   UB_vec;
+    DoubleVec   bmatch_edge_vec;
+    ifstream    fin_strm;
+    ofstream    fout_strm;
+    StreamBmatch SALG;
+
+    bool is_weights_file = (PP.weights.find("NULL", 0) == string::npos);
+    bool is_degrees_file = (PP.degrees.find("NULL", 0) == string::npos);
+    bool is_output_file = (PP.output.find("NULL", 0) == string::npos);
+    bool is_profile_file = (PP.profile.find("NULL", 0) == string::npos);
+
+    if (PP.sparse!=1)
+    {
+        cerr << "bmatch!> -stream needs IJW input (-sparse 1)" << endl;
+        return 1;
+    }
+
+    /* degrees */
+    if (PP.const_u>=0)
+    {
+        SALG.const_ub = PP.const_u;
+    }
+    else
+    {
+        if (is_degrees_file)
+        {
+            fin_strm.open(PP.degrees.c_str());
+            read_mn_matrix(fin_strm, M, N, deg_bdd_vec);
+            fin_strm.close();
+        }
+        else
+        {
+            cerr << "INPUT DEGREES>" << endl;
+            read_mn_matrix(cin, M, N, deg_bdd_vec);
+        }
+        if ((M==1) && (N==1))
+        {
+            /* constant */
+            SALG.const_ub = deg_bdd_vec[0];
+            deg_bdd_vec.clear();
+        }
+        else if ((N==1) || ((M==1) && (N>2)))
+        {
+            /* upper bounds, as a column or a row */
+            UB_vec.swap(deg_bdd_vec);
+            for (i=0; i<M*N; i++)
+            {
+                deg_bdd_vec.push_back(0.0);
+                deg_bdd_vec.push_back(UB_vec[i]);
+            }
+        }
+        else if (N!=2)
+        {
+            cerr << "read_degrees!> unrecognized format" << endl;
+            return 1;
+        }
+    }
+
+    /* weights */
+    SALG.eps = PP.stream_eps;
+    solve_time = wall_clock();
+    if (is_weights_file)
+    {
+        fin_strm.open(PP.weights.c_str());
+        success = SALG.solve_bmatching_stream(fin_strm, deg_bdd_vec, num_node, num_entry, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, PP.verbose);
+        fin_strm.close();
+    }
+    else
+    {
+        cerr << "INPUT WEIGHTS(sparse)>" << endl;
+        success = SALG.solve_bmatching_stream(cin, deg_bdd_vec, num_node, num_entry, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, PP.verbose);
+    }
+    solve_time = wall_clock() - solve_time;
+
+    /* output */
+    if (is_output_file)
+    {
+        fout_strm.open(PP.output.c_str());
+        ijw_write_ijw(fout_strm, num_bmatch_edge, bmatch_edge_vec, 3);
+        fout_strm.close();
+    }
+    else
+    {
+        cerr << "MATCHING>" << endl;
+        ijw_write_ijw(cout, num_bmatch_edge, bmatch_edge_vec, 3);
+    }
+
+    if (PP.verbose>0)
+    {
+        cerr << "bmatch done:" << endl;
+        cerr << "       method = " << SALG.description() << endl;
+        cerr << "   in # nodes = " << num_node << endl;
+        cerr << "   in # edges = " << num_entry << endl;
+        cerr << "  out # edges = " << num_bmatch_edge << endl;
+        cerr << "          wgt = " << bmatch_wgt << endl;
+        cerr << "  time (sec.) = " << solve_time << endl;
+        SALG.profile.write_summary(cerr, "solver ");
+    }
+
+    /* machine-readable solve profile */
+    if (is_profile_file)
+    {
+        fout_strm.open(PP.profile.c_str());
+        write_solve_json(fout_strm, SALG.description(), num_node, int(min(num_entry, 2147483647.0)), num_bmatch_edge, bmatch_wgt, success, solve_time, SALG.profile);
+        fout_strm.close();
+    }
+    if (PP.stats)
+    {
+        write_solve_json(cerr, SALG.description(), num_node, int(min(num_entry, 2147483647.0)), num_bmatch_edge, bmatch_wgt, success, solve_time, SALG.profile);
+    }
+
+    return (success ? 0 : 1);
+}
+/* end stream_bmatch */
+
+
+
 /******************************************************************/
 /* Interface for the ijw-based MEX function */
 /******************************************************************/
@@ -132,12 +408,32 @@ int main(int argc, char *argv[])
     DoubleVec       bmatch_edge_vec;
     double          bmatch_wgt;
 
-    time_t          time1;
-    time_t          time2;
     double          total_time;
 
+    double          solve_time;
+    SolveProfile    profile;
+    SolveProfile    run_profile;
+
 
     AbstractBmatchSolver * ALG;
+    AbstractBmatchSolver * XALG;
+    AugmentImproveBmatch IMP;
+    int             is_full_output;
+    double          improve_time;
+    int             num_full_ijw;
+    DoubleVec       full_ijw_vec;
+    int             num_fit_ijw;
+    int             is_bound;
+    int             num_exact_edge;
+    DoubleVec       exact_edge_vec;
+    double          exact_wgt;
+    vector<int>     order_vec;
+    vector<int>     label_vec;
+    DoubleVec       L_deg_bdd_vec;
+    double          reorder_time;
+    int             bandwidth = 0;
+    vector<bool>    keep_vec;
+    BmatchVerification VER;
 
     string method_str;
 
@@ -149,7 +445,7 @@ int main(int argc, char *argv[])
     ostream         * out_strm_ptr;
 
     /* */
-    time1 = time(&time1);
+    total_time = wall_clock();
 
 
     cout.precision(4);
@@ -160,11 +456,32 @@ int main(int argc, char *argv[])
         " -weights      NULL "
         " -degrees      NULL "
         " -output       NULL "
+        " -profile      NULL "
         " -l            -1   "
         " -u            -1   "
         " -s            0    "
         " -method       1    "
         " -verbose      0    "
+        " -queue        -1   "
+        " -primal_dual  -1   "
+        " -threads      0    "
+        " -improve      0    "
+        " -eps          0    "
+        " -time_limit   0    "
+        " -initial      NULL "
+        " -stream       0    "
+        " -stream_eps   0.1  "
+        " -topk         0    "
+        " -topk_verify  0    "
+        " -reorder      0    "
+        " -seed         0    "
+        " -prune        0    "
+        " -bipartite    -1   "
+        " -stats        0    "
+        " -max_mem      0    "
+        " -serve        NULL "
+        " -workers      0    "
+        " -accuracy     0.5  "
     );
     /* parse cmd line */
     PP.init(argc,argv);
@@ -177,8 +494,24 @@ int main(int argc, char *argv[])
     bool is_weights_file = (PP.weights.find("NULL", 0) == string::npos);
     bool is_degrees_file = (PP.degrees.find("NULL", 0) == string::npos);
     bool is_output_file = (PP.output.find("NULL", 0) == string::npos);
+    bool is_profile_file = (PP.profile.find("NULL", 0) == string::npos);
+    bool is_initial_file = (PP.initial.find("NULL", 0) == string::npos);
+    bool is_serve = (PP.serve.find("NULL", 0) == string::npos);
+
+    /* server mode */
+    if (is_serve)
+    {
+        return serve_bmatch(PP);
+    }
+
+    /* semi-streaming mode */
+    if (PP.stream)
+    {
+        return stream_bmatch(PP);
+    }
 
     /* missing files */
+    run_profile.start("parse");
     if (!is_weights_file) 
     {
         in_strm_ptr = &cin;
@@ -267,6 +600,7 @@ int main(int argc, char *argv[])
             exit(1);
         }
     }
+    run_profile.stop("parse");
     /* */
     if ((!is_weights_file) || ((!is_degrees_file)&&(PP.const_u<0)) )
     {
@@ -293,40 +627,208 @@ int main(int argc, char *argv[])
     /*****************************************************************/
     /* bmatch_ijw interface */
     /*****************************************************************/
-    switch (PP.method) {
-        case 1: 
-            ALG = new ComplementaryGoblinExactBmatch();
-            break;
-        case 2: 
-            ALG = new GoblinExactBmatch();
-            break;
-        case 3: 
-            ALG = new GreedyApproxBmatch();
-            break;
-        case 4: 
-            ALG = new RecursiveGreedyApproxBmatch();
-            break;
-        case 5: 
-            ALG = new BeliefPropBmatch();
-            /* use full matrix */
-            ijw_add_upper_tri_transpose(num_ijw, ijw_vec, 1);
-            break;
-        default:
+    /* keep the ceil(topk * u_i) heaviest edges of each node i */
+    run_profile.start("preprocess");
+    if ((PP.topk>0) || (PP.max_mem>0))
+    {
+        /* the input graph, for the verifier, while edges may be dropped */
+        num_full_ijw = num_ijw;
+        full_ijw_vec = ijw_vec;
+    }
+    if (PP.topk>0)
+    {
+        keep_topk(num_node, deg_bdd_vec, PP.topk, num_ijw, ijw_vec);
+        run_profile.count("topk_dropped_edges", num_full_ijw - num_ijw);
+        if (verbose>0)
+        {
+            cerr << "bmatch> top-k kept " << num_ijw << " of " << num_full_ijw << " edges" << endl;
+        }
+    }
+    /* relabel the nodes for locality, undone on output */
+    if (PP.reorder>0)
+    {
+        reorder_time = wall_clock();
+        keep_vec.assign(num_node, true);
+        ijw_keep_upper_tri(num_ijw, ijw_vec, keep_vec);
+        bandwidth = ijw_bandwidth(num_ijw, ijw_vec);
+        ijw_node_order(num_node, num_ijw, ijw_vec, PP.reorder, order_vec);
+        label_vec.resize(num_node);
+        L_deg_bdd_vec.resize(2*num_node);
+        for (k=0; k<num_node; k++)
+        {
+            label_vec[order_vec[k]] = k;
+            L_deg_bdd_vec[2*k+0] = deg_bdd_vec[2*order_vec[k]+0];
+            L_deg_bdd_vec[2*k+1] = deg_bdd_vec[2*order_vec[k]+1];
+        }
+        deg_bdd_vec.swap(L_deg_bdd_vec);
+        ijw_relabel(num_ijw, ijw_vec, label_vec, 1);
+        reorder_time = wall_clock() - reorder_time;
+        if (verbose>0)
+        {
+            cerr << "bmatch> reorder bandwidth " << bandwidth << " -> " << ijw_bandwidth(num_ijw, ijw_vec);
+            cerr << " (" << reorder_time << " sec.)" << endl;
+        }
+    }
+    /* fastest method of the required accuracy */
+    if ((PP.method==0) && (!is_initial_file))
+    {
+        PP.method = select_method(num_node, deg_bdd_vec, num_ijw, IjwView(ijw_vec), PP.accuracy, PP.max_mem, BSuitorApproxBmatch::select_num_thread(PP.threads), (verbose>0) ? &cerr : NULL);
+        run_profile.count("auto_method", PP.method);
+    }
+    run_profile.stop("preprocess");
+    /* compare goblin priority queues, then solve as usual */
+    if ((PP.queue==-2) && ((PP.method==1) || (PP.method==2)))
+    {
+        benchmark_goblin_queues(PP, num_node, deg_bdd_vec, num_ijw, ijw_vec, verbose);
+        PP.queue = GOBLIN_PQ_AUTO;
+    }
+    run_profile.start("solve");
+    if (is_initial_file)
+    {
+        /* improve a b-matching read from file, instead of solving */
+        fin_strm.open(PP.initial.c_str());
+        ijw_read_ijw(fin_strm, num_bmatch_edge, bmatch_edge_vec);
+        fin_strm.close();
+        if (PP.reorder>0)
+        {
+            ijw_relabel(num_bmatch_edge, bmatch_edge_vec, label_vec, 1);
+        }
+        method_str = string("initial b-matching ") + PP.initial;
+        success = 1;
+        solve_time = 0.0;
+    }
+    else
+    {
+        ALG = new_solver(PP.method, PP);
+        if (ALG==NULL)
+        {
             cerr << "Method not recognized" << endl;
             exit(1);
+        }
+        /* lighter method or fewer edges within the memory budget */
+        if (PP.max_mem>0)
+        {
+            num_fit_ijw = num_ijw;
+            ALG = fit_memory_budget(ALG, PP, num_node, deg_bdd_vec, num_ijw, ijw_vec, run_profile);
+            if (ALG==NULL)
+            {
+                cerr << "bmatch!> no method fits in -max_mem " << PP.max_mem << " MB" << endl;
+                exit(1);
+            }
+            if ((num_ijw==num_fit_ijw) && (PP.topk<=0))
+            {
+                /* no edges dropped, the ijw is the input graph */
+                DoubleVec().swap(full_ijw_vec);
+            }
+        }
+        if (PP.method==5)
+        {
+            /* use full matrix */
+            ijw_add_upper_tri_transpose(num_ijw, ijw_vec, 1);
+        }
+        /* */
+        /* */
+        method_str = ALG->description();
+        ALG->seed = (unsigned int)(PP.seed);
+        ALG->profile.goblin_timers = int(is_profile_file || PP.stats);
+        solve_time = wall_clock();
+        success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+        solve_time = wall_clock() - solve_time;
+        profile = ALG->profile;
+        /* */
+        delete ALG;
+        /* */
+        /* */
+        if (PP.method==5) /* special case */
+        {
+            bmatch_wgt = 0.5*bmatch_wgt;
+        }
     }
-    /* */
-    /* */
-    method_str = ALG->description();
-    success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
-    /* */
-    delete ALG;
-    /* */
-    /* */
-    if (PP.method==5) /* special case */
+    is_full_output = (!is_initial_file) && (PP.method==5);
+
+    /* post-optimization by short augmentations */
+    if (success && (is_initial_file || (PP.improve>0)))
+    {
+        IMP.max_len = max(PP.improve, 0);
+        IMP.eps = PP.eps;
+        IMP.time_limit = PP.time_limit;
+        IMP.profile = profile;
+        if (PP.method==5)
+        {
+            /* back to the upper triangle, in linear time */
+            keep_vec.assign(num_node, true);
+            ijw_keep_upper_tri(num_ijw, ijw_vec, keep_vec);
+        }
+        improve_time = wall_clock();
+        success = IMP.improve_bmatching(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+        solve_time += wall_clock() - improve_time;
+        profile = IMP.profile;
+        method_str = method_str + ", " + IMP.description();
+        is_full_output = 0;
+    }
+    run_profile.stop("solve");
+
+    /* exact b-matching of the kept edges, to measure the loss of the
+     * method alone (the exact solver ignores entries below the diagonal) */
+    if (success && (PP.topk>0) && PP.topk_verify)
+    {
+        XALG = new_solver(1, PP);
+        num_exact_edge = 0;
+        if (XALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_exact_edge, exact_edge_vec, exact_wgt, max(verbose-1, 0)))
+        {
+            cerr << "bmatch> top-k verify: wgt " << bmatch_wgt << ", exact wgt of the kept edges " << exact_wgt << endl;
+            profile.count("topk_exact_wgt", exact_wgt);
+        }
+        else
+        {
+            cerr << "bmatch!> top-k verify: exact solver failed" << endl;
+        }
+        delete XALG;
+    }
+
+    /* original node labels */
+    run_profile.start("extract");
+    if (PP.reorder>0)
+    {
+        profile.count("reorder_bandwidth_in", bandwidth);
+        profile.count("reorder_bandwidth", ijw_bandwidth(num_ijw, ijw_vec));
+        reorder_time -= wall_clock();
+        ijw_relabel(num_bmatch_edge, bmatch_edge_vec, order_vec, !is_full_output);
+        ijw_relabel(num_ijw, ijw_vec, order_vec, !is_full_output);
+        deg_bdd_vec.swap(L_deg_bdd_vec);
+        reorder_time += wall_clock();
+        profile.count("reorder_sec", reorder_time);
+    }
+    run_profile.stop("extract");
+
+    /* feasibility, weight and LP bound of the b-matching, against the
+     * input graph if top-k or -max_mem dropped edges; the bound is that of
+     * a max-weight b-matching, which the mincost method 2 is not */
+    run_profile.start("verify");
+    is_bound = is_initial_file || (PP.method!=2);
+    if (full_ijw_vec.size()>0)
     {
-        bmatch_wgt = 0.5*bmatch_wgt;
+        verify_bmatching(num_node, deg_bdd_vec, num_full_ijw, IjwView(full_ijw_vec), num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, is_full_output, VER);
     }
+    else
+    {
+        verify_bmatching(num_node, deg_bdd_vec, num_ijw, IjwView(ijw_vec), num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, is_full_output, VER);
+    }
+    run_profile.count("verify_violations", VER.num_violation());
+    if (is_bound)
+    {
+        run_profile.count("verify_upper_bound", VER.upper_bound);
+        run_profile.count("verify_ratio", VER.ratio);
+    }
+    if (VER.num_violation()>0)
+    {
+        VER.write(cerr, "bmatch verify!> ", is_bound);
+    }
+    else if (verbose>0)
+    {
+        VER.write(cerr, "bmatch verify> ", is_bound);
+    }
+    run_profile.stop("verify");
     /* */
     /*****************************************************************/
 
@@ -337,6 +839,7 @@ int main(int argc, char *argv[])
     /*****************************************************************/
 
     /* redirect */
+    run_profile.start("write");
     if (!is_output_file) 
     {
         out_strm_ptr = &cout;
@@ -353,13 +856,13 @@ int main(int argc, char *argv[])
     }
     else
     {
-        if (PP.method!=5) /* special case */
+        if (!is_full_output) /* special case */
         {
             ijw_add_upper_tri_transpose(num_bmatch_edge, bmatch_edge_vec, 1);
         }
         /* write full symmetrix matrix in ijw format */
         ijw_write_matrix(*out_strm_ptr,num_node,num_bmatch_edge,bmatch_edge_vec,3);
-        if (PP.method!=5) /* special case */
+        if (!is_full_output) /* special case */
         {
             ijw_upper_tri(num_bmatch_edge, bmatch_edge_vec, 0);
         }
@@ -368,10 +871,10 @@ int main(int argc, char *argv[])
     {
         fout_strm.close();
     }
+    run_profile.stop("write");
 
     /* */
-    time2 = time(&time2);
-    total_time = difftime(time2, time1);
+    total_time = wall_clock() - total_time;
 
     if (verbose>0)
     {
@@ -382,13 +885,32 @@ int main(int argc, char *argv[])
         cerr << "  out # edges = " << num_bmatch_edge << endl;
         cerr << "          wgt = " << bmatch_wgt << endl;
         cerr << "  time (sec.) = " << total_time << endl;
+        run_profile.write_summary(cerr);
+        profile.write_summary(cerr, "solver ");
+    }
+
+    /* machine-readable solve profile */
+    if (is_profile_file)
+    {
+        fout_strm.open(PP.profile.c_str());
+        write_solve_json(fout_strm, method_str, num_node, num_ijw, num_bmatch_edge, bmatch_wgt, success, solve_time, profile, &run_profile);
+        fout_strm.close();
+    }
+    if (PP.stats)
+    {
+        write_solve_json(cerr, method_str, num_node, num_ijw, num_bmatch_edge, bmatch_wgt, success, solve_time, profile, &run_profile);
     }
 
 #ifdef _LEAKTEST_
     sleep(600);
 #endif
 
-    return (~success);
+    /* 0 => a verified b-matching, 1 => the solver failed, 2 => violations */
+    if (!success)
+    {
+        return 1;
+    }
+    return (VER.num_violation()>0) ? 2 : 0;
 }
 /* end of main */
 
@@ -0,0 +1,365 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ *
+ * generator of synthetic ijw graphs and degree bounds, for scale testing
+ *
+ * the chunks of the graph are drawn by a pool of threads, a wave at a
+ * time, while the previous wave is written in chunk order, so that the
+ * output of a seed does not depend on the number of threads
+ * */
+#include <iostream>
+#include <string>
+using namespace std;
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <pthread.h>
+#include "SolveProfile.hpp"
+#include "synthetic.hpp"
+
+/* chunks of a wave, per thread */
+#define GEN_WAVE_CHUNKS (4)
+
+/* weights below this are written as integers when integral */
+#define GEN_MAX_INT (2147483647.0)
+
+
+/* a wave of chunks, drawn by the threads */
+class GenWave
+{
+    public:
+        /* graph, and output format: 0 => text, 1 => binary */
+        const SyntheticGraph * G;
+        int is_binary;
+
+        /* chunks first .. last-1, the next one to draw, and its lock */
+        int first;
+        int last;
+        int next;
+        pthread_mutex_t lock;
+
+        /* formatted edges of the chunks, and their number */
+        vector<string> buf_vec;
+        vector<int> count_vec;
+};
+
+
+/* append the decimal digits of a non-negative integer to buf */
+static void gen_append_int(string & buf, unsigned int x)
+{
+    char        digit[16];
+    int         k;
+
+    k = 0;
+    do
+    {
+        digit[k++] = char('0' + x%10);
+        x /= 10;
+    } while (x>0);
+    while (k>0)
+    {
+        buf.push_back(digit[--k]);
+    }
+}
+/* end gen_append_int */
+
+
+/* draw the chunks of a wave, until there are none left */
+static void * gen_thread(void * arg)
+{
+    register int k;
+    int         c;
+    int         num_ijw;
+    char        line[96];
+    DoubleVec   ijw_vec;
+    GenWave *   wave = (GenWave *)(arg);
+
+    while (1)
+    {
+        pthread_mutex_lock(&wave->lock);
+        c = wave->next++;
+        pthread_mutex_unlock(&wave->lock);
+        if (c>=wave->last)
+        {
+            break;
+        }
+        wave->G->chunk_ijw(c, num_ijw, ijw_vec);
+        string & buf = wave->buf_vec[c - wave->first];
+        buf.clear();
+        if (wave->is_binary)
+        {
+            if (num_ijw>0)
+            {
+                buf.append((const char *)(&ijw_vec[0]), 3*num_ijw*sizeof(double));
+            }
+        }
+        else
+        {
+            /* printf only for the weights that are not integers */
+            buf.reserve(32*num_ijw);
+            for (k=0; k<num_ijw; k++)
+            {
+                gen_append_int(buf, (unsigned int)(ijw_vec[3*k+0]));
+                buf.push_back(' ');
+                gen_append_int(buf, (unsigned int)(ijw_vec[3*k+1]));
+                buf.push_back(' ');
+                if ((ijw_vec[3*k+2]==floor(ijw_vec[3*k+2])) && (ijw_vec[3*k+2]>=0) && (ijw_vec[3*k+2]<=GEN_MAX_INT))
+                {
+                    gen_append_int(buf, (unsigned int)(ijw_vec[3*k+2]));
+                    buf.push_back('\n');
+                }
+                else
+                {
+                    snprintf(line, sizeof(line), "%.17g\n", ijw_vec[3*k+2]);
+                    buf.append(line);
+                }
+            }
+        }
+        wave->count_vec[c - wave->first] = num_ijw;
+    }
+    return NULL;
+}
+/* end gen_thread */
+
+
+/* */
+static void gen_print_help()
+{
+    cerr << "usage: bmatch_gen [options]" << endl;
+    cerr << endl;
+    cerr << "Writes a synthetic graph as an upper triangle ijw (i<j, 0-based, no" << endl;
+    cerr << "duplicates), and optionally its degree bounds as an Nx2 [LB UB] file." << endl;
+    cerr << "The graph of a seed does not depend on the number of threads." << endl;
+    cerr << endl;
+    cerr << "Arguments [with default values]:" << endl;
+    cerr << "    -g -graph    [random ] random (Erdos-Renyi), powerlaw (Chung-Lu), block," << endl;
+    cerr << "                           dense, bipartite or knn (geometric kNN)" << endl;
+    cerr << "    -n           [1000   ] nodes" << endl;
+    cerr << "    -m           [0      ] expected edges, 0 => from -deg" << endl;
+    cerr << "    -d -deg      [8      ] average degree of random, powerlaw and bipartite" << endl;
+    cerr << "    -gamma       [2.5    ] degree exponent of powerlaw" << endl;
+    cerr << "    -k -knn      [8      ] neighbours of knn" << endl;
+    cerr << "    -block       [9      ] nodes of each block of block" << endl;
+    cerr << "    -w -weights  [uniform] uniform (0,max_wgt], exp (mean max_wgt), int" << endl;
+    cerr << "                           1..max_wgt, const max_wgt, or dist (knn only," << endl;
+    cerr << "                           max_wgt/(1+sqrt(n)*length))" << endl;
+    cerr << "    -max_wgt     [1      ] scale of the weights" << endl;
+    cerr << "    -sd -seed    [1      ] seed" << endl;
+    cerr << "    -t -threads  [0      ] threads, 0 => all cores" << endl;
+    cerr << "    -f -format   [text   ] text (\"i j w\" lines) or binary (3 doubles per edge)" << endl;
+    cerr << "    -o -output   [NULL   ] ijw file, NULL => stdout" << endl;
+    cerr << "    -degrees     [NULL   ] degree bounds file, NULL => none" << endl;
+    cerr << "    -l           [0      ] lower bound of every node" << endl;
+    cerr << "    -u           [1      ] upper bound of every node" << endl;
+    cerr << "    -u_max       [0      ] > u => upper bounds uniform in u..u_max" << endl;
+    cerr << "    -v -verbose  [1      ] 0 => quiet" << endl;
+    exit(1);
+}
+/* end gen_print_help */
+
+
+/* */
+int main(int argc, char *argv[])
+{
+    register int i;
+    register int k;
+    int         w;
+    int         t;
+    int         num_thread = 0;
+    int         num_wave_chunk;
+    int         is_binary = 0;
+    int         verbose = 1;
+    int         const_l = 0;
+    int         const_u = 1;
+    int         max_u = 0;
+    double      num_edge = 0.0;
+    double      num_out = 0.0;
+    double      gen_time;
+    string      output("NULL");
+    string      degrees("NULL");
+    SyntheticGraph G;
+    GenWave     wave[2];
+    vector<pthread_t> thread_vec;
+    FILE *      out;
+
+    G.num_node = 1000;
+
+    /* parse cmd line */
+    for (i=1; i<argc; i++)
+    {
+        if ((string("-h")==argv[i]) || (string("-help")==argv[i]) || (i+1>=argc))
+        {
+            gen_print_help();
+        }
+        if ((string("-graph")==argv[i]) || (string("-g")==argv[i])) {
+            G.kind = synthetic_kind(argv[++i]); continue;
+        }
+        if (string("-n")==argv[i]) {
+            G.num_node = atoi(argv[++i]); continue;
+        }
+        if (string("-m")==argv[i]) {
+            num_edge = atof(argv[++i]); continue;
+        }
+        if ((string("-deg")==argv[i]) || (string("-d")==argv[i])) {
+            G.avg_deg = atof(argv[++i]); continue;
+        }
+        if (string("-gamma")==argv[i]) {
+            G.gamma = atof(argv[++i]); continue;
+        }
+        if ((string("-knn")==argv[i]) || (string("-k")==argv[i])) {
+            G.knn = atoi(argv[++i]); continue;
+        }
+        if (string("-block")==argv[i]) {
+            G.block_size = atoi(argv[++i]); continue;
+        }
+        if ((string("-weights")==argv[i]) || (string("-w")==argv[i])) {
+            G.wgt_kind = synthetic_wgt_kind(argv[++i]); continue;
+        }
+        if (string("-max_wgt")==argv[i]) {
+            G.max_wgt = atof(argv[++i]); continue;
+        }
+        if ((string("-seed")==argv[i]) || (string("-sd")==argv[i])) {
+            G.seed = (unsigned int)(atoi(argv[++i])); continue;
+        }
+        if ((string("-threads")==argv[i]) || (string("-t")==argv[i])) {
+            num_thread = atoi(argv[++i]); continue;
+        }
+        if ((string("-format")==argv[i]) || (string("-f")==argv[i])) {
+            is_binary = (string("binary")==argv[++i]); continue;
+        }
+        if ((string("-output")==argv[i]) || (string("-o")==argv[i])) {
+            output = string(argv[++i]); continue;
+        }
+        if (string("-degrees")==argv[i]) {
+            degrees = string(argv[++i]); continue;
+        }
+        if (string("-l")==argv[i]) {
+            const_l = atoi(argv[++i]); continue;
+        }
+        if (string("-u")==argv[i]) {
+            const_u = atoi(argv[++i]); continue;
+        }
+        if (string("-u_max")==argv[i]) {
+            max_u = atoi(argv[++i]); continue;
+        }
+        if ((string("-verbose")==argv[i]) || (string("-v")==argv[i])) {
+            verbose = atoi(argv[++i]); continue;
+        }
+        cerr << "bmatch_gen!> unrecognized option " << argv[i] << endl;
+        gen_print_help();
+    }
+    if (num_edge>0)
+    {
+        G.avg_deg = 2.0*num_edge/max(G.num_node, 1);
+    }
+    if (!G.init())
+    {
+        exit(1);
+    }
+    if (num_thread<=0)
+    {
+        num_thread = max(1, int(sysconf(_SC_NPROCESSORS_ONLN)));
+    }
+
+    /* degree bounds */
+    if (degrees.find("NULL", 0)==string::npos)
+    {
+        SyntheticRand rnd(~G.seed);
+        out = fopen(degrees.c_str(), "w");
+        if (out==NULL)
+        {
+            cerr << "bmatch_gen!> cannot write " << degrees << endl;
+            exit(1);
+        }
+        for (i=0; i<G.num_node; i++)
+        {
+            fprintf(out, "%d %d\n", const_l, (max_u>const_u) ? const_u + rnd.below(max_u - const_u + 1) : const_u);
+        }
+        fclose(out);
+    }
+
+    /* graph */
+    if (output.find("NULL", 0)==string::npos)
+    {
+        out = fopen(output.c_str(), is_binary ? "wb" : "w");
+        if (out==NULL)
+        {
+            cerr << "bmatch_gen!> cannot write " << output << endl;
+            exit(1);
+        }
+    }
+    else
+    {
+        out = stdout;
+    }
+
+    /* waves of chunks, each drawn while the one before is written */
+    gen_time = wall_clock();
+    num_wave_chunk = GEN_WAVE_CHUNKS*num_thread;
+    thread_vec.resize(num_thread);
+    for (w=0; w<2; w++)
+    {
+        wave[w].G = &G;
+        wave[w].is_binary = is_binary;
+        wave[w].first = 0;
+        wave[w].last = 0;
+        wave[w].buf_vec.resize(num_wave_chunk);
+        wave[w].count_vec.resize(num_wave_chunk);
+        pthread_mutex_init(&wave[w].lock, NULL);
+    }
+    for (w=0; wave[(w+1)%2].last<G.num_chunk(); w++)
+    {
+        GenWave & cur = wave[w%2];
+        GenWave & prev = wave[(w+1)%2];
+        cur.first = prev.last;
+        cur.last = min(cur.first + num_wave_chunk, G.num_chunk());
+        cur.next = cur.first;
+        for (t=0; t<num_thread; t++)
+        {
+            pthread_create(&thread_vec[t], NULL, gen_thread, (void *)(&cur));
+        }
+        for (k=0; (w>0) && (k<prev.last - prev.first); k++)
+        {
+            fwrite(prev.buf_vec[k].data(), 1, prev.buf_vec[k].size(), out);
+            num_out += prev.count_vec[k];
+        }
+        for (t=0; t<num_thread; t++)
+        {
+            pthread_join(thread_vec[t], NULL);
+        }
+    }
+    for (k=0; (w>0) && (k<wave[(w+1)%2].last - wave[(w+1)%2].first); k++)
+    {
+        fwrite(wave[(w+1)%2].buf_vec[k].data(), 1, wave[(w+1)%2].buf_vec[k].size(), out);
+        num_out += wave[(w+1)%2].count_vec[k];
+    }
+    for (w=0; w<2; w++)
+    {
+        pthread_mutex_destroy(&wave[w].lock);
+    }
+    if (out!=stdout)
+    {
+        fclose(out);
+    }
+    else
+    {
+        fflush(out);
+    }
+    gen_time = wall_clock() - gen_time;
+
+    if (verbose>0)
+    {
+        cerr << "bmatch_gen done:" << endl;
+        cerr << "        graph = " << synthetic_name(G.kind) << endl;
+        cerr << "      # nodes = " << G.num_node << endl;
+        cerr << "      # edges = " << num_out << " (expected " << G.expected_edges() << ")" << endl;
+        cerr << "      threads = " << num_thread << endl;
+        cerr << "  time (sec.) = " << gen_time << endl;
+        cerr << "    edges/sec = " << ((gen_time>0) ? num_out/gen_time : 0.0) << endl;
+    }
+    return 0;
+}
+/* end main */
+
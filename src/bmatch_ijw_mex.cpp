@@ -9,254 +9,500 @@
  * */
 
 #include <string>
+#include <sstream>
 using namespace std;
 #include <time.h>
+#include <pthread.h>
 #include "mex.h"
 #include "Vector.hpp"
-#include "goblinexact.hpp"
 #include "AbstractBmatchSolver.hpp"
-#include "greedyapprox.hpp"
-#include "goblinexact.hpp"
-#include "beliefprop.hpp"
+#include "newsolver.hpp"
+#include "bsuitor.hpp"
 
 /* from mathworks mexcpp.cpp */
 extern void _main();
 
-/******************************************************************/
-/* Interface for the ijw-based MEX function */
-/******************************************************************/
-void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+
+/* a problem of a call, read from the matlab arrays, and its result */
+class MexProblem
 {
-    register int    k;
-    int             ii;
-    const int *     dims;
+    public:
+        /* input, the ijw columns read in place */
+        int num_node;
+        DoubleVec deg_bdd_vec;
+        int num_ijw;
+        const double * ijw_ptr;
 
-    int             verbose;
-    int             method;
-    int             success;
+        /* result */
+        int success;
+        int num_bmatch_edge;
+        DoubleVec bmatch_edge_vec;
+        double bmatch_wgt;
+        double solve_time;
+        string method_str;
+        SolveProfile profile;
+};
 
-    int             num_node;
-    const double *  deg_bdd_ptr;
-    DoubleVec       deg_bdd_vec;
 
-    int             num_ijw;
-    const double *  ijw_ptr;
-    DoubleVec       ijw_vec;
+/* the problems of a call, taken in turn by a pool of threads */
+class MexPool
+{
+    public:
+        vector<MexProblem> * problem_vec_ptr;
 
-    int             num_bmatch_edge;
-    double *        bmatch_edge_ptr;
-    DoubleVec       bmatch_edge_vec;
-    double          bmatch_wgt;
+        /* solver options, with one thread for method 6 */
+        Parameter PP;
+        int goblin_timers;
 
-    time_t          time1;
-    time_t          time2;
-    double          total_time;
+        /* threads of the pool */
+        int num_thread;
 
-    AbstractBmatchSolver * ALG;
-    string          method_str;
+        /* the next problem to solve, and its lock */
+        int next;
+        pthread_mutex_t lock;
+};
 
-    /* */
-    time1 = time(&time1);
 
-    /* */
-    num_bmatch_edge = 0;
-    bmatch_edge_vec.clear();
-    bmatch_wgt = -1;
-
-    /* one or two outputs */
-    if (nlhs > 3) {
-        mexErrMsgTxt("Too many output arguments.\n");
-    }
+/* read the ijw (in place) and degree bounds of a problem, arg_str naming
+ * the arguments in the error messages, e.g. "{2}" for the second cells */
+static void mex_read_problem(const mxArray * ijw_arr, const mxArray * deg_arr, const string & arg_str, MexProblem & P)
+{
+    register int k;
+    const int *     dims;
+    const double *  deg_bdd_ptr;
 
     /* first argument */
-    ii = 0;
-    if (mxGetClassID(prhs[ii])!=mxDOUBLE_CLASS) {
-        mexErrMsgTxt("Could not convert ARG 1 to double.");
+    if (mxGetClassID(ijw_arr)!=mxDOUBLE_CLASS) {
+        mexErrMsgTxt(("Could not convert ARG 1" + arg_str + " to double.").c_str());
     }
-    if (mxGetNumberOfDimensions(prhs[ii])<2) {
-        mexErrMsgTxt("Could not convert ARG 1 to weighted edge list.");
+    if (mxGetNumberOfDimensions(ijw_arr)<2) {
+        mexErrMsgTxt(("Could not convert ARG 1" + arg_str + " to weighted edge list.").c_str());
     }
-    dims = mxGetDimensions(prhs[ii]);
-    num_ijw = int(dims[0]);
+    dims = mxGetDimensions(ijw_arr);
+    P.num_ijw = int(dims[0]);
     if (dims[1]!=3) {
-        mexErrMsgTxt("size(ARG_1) must be NUM_EDGE x 3.");
+        mexErrMsgTxt(("size(ARG_1" + arg_str + ") must be NUM_EDGE x 3.").c_str());
     }
     /* */
-    ijw_ptr = mxGetPr(prhs[ii]);
+    P.ijw_ptr = mxGetPr(ijw_arr);
 
     /* find the maximum node number */
-    num_node = -1;
-    for (ii=0; ii<2*num_ijw; ii++) {
-        if (ijw_ptr[ii]>num_node) {
-            num_node = int(ijw_ptr[ii]);
+    P.num_node = -1;
+    for (k=0; k<2*P.num_ijw; k++) {
+        if (P.ijw_ptr[k]>P.num_node) {
+            P.num_node = int(P.ijw_ptr[k]);
         }
     }
-    num_node = num_node + 1;
+    P.num_node = P.num_node + 1;
 
     /* second argument */
-    ii = 1;
-    if (mxGetClassID(prhs[ii])!=mxDOUBLE_CLASS) {
-        mexErrMsgTxt("Could not convert ARG 2 to double.");
+    if (mxGetClassID(deg_arr)!=mxDOUBLE_CLASS) {
+        mexErrMsgTxt(("Could not convert ARG 2" + arg_str + " to double.").c_str());
     }
-    if (mxGetNumberOfDimensions(prhs[ii])<2) {
-        mexErrMsgTxt("Could not convert ARG 2 to degree bounds.");
+    if (mxGetNumberOfDimensions(deg_arr)<2) {
+        mexErrMsgTxt(("Could not convert ARG 2" + arg_str + " to degree bounds.").c_str());
     }
-    dims = mxGetDimensions(prhs[ii]);
-    if ((dims[0]<num_node) || (dims[1]!=2)) {
-        mexErrMsgTxt("size(ARG_2) must be Nx2, N > max(max(ARG_1(:,[1,2]))).");
+    dims = mxGetDimensions(deg_arr);
+    if ((dims[0]<P.num_node) || (dims[1]!=2)) {
+        mexErrMsgTxt(("size(ARG_2" + arg_str + ") must be Nx2, N > max(max(ARG_1" + arg_str + "(:,[1,2]))).").c_str());
     }
     /* */
-    deg_bdd_ptr = mxGetPr(prhs[ii]);
+    deg_bdd_ptr = mxGetPr(deg_arr);
 
     /* update maximum node number */
-    if (dims[0]>num_node) {
-        num_node = dims[0];
+    if (dims[0]>P.num_node) {
+        P.num_node = dims[0];
     }
 
-    /* optional third argument */
-    method = 1;
-    if (nrhs > 2) {
-        ii = 2;
-        if (mxGetClassID(prhs[ii])!=mxDOUBLE_CLASS) {
-            mexErrMsgTxt("Could not convert ARG 3 to double.");
-        }
-        if (mxGetNumberOfElements(prhs[ii])!=1) {
-            mexErrMsgTxt("Could not convert ARG 3 to scalar.");
-        }
-        /* */
-        method = int(*mxGetPr(prhs[ii]));
+    /* copy the degree bounds into STL vectors; the ijw columns are read
+     * in place, through an IjwView, by all methods but 5 */
+    P.deg_bdd_vec.clear();
+    P.deg_bdd_vec.reserve(2*P.num_node);
+    for (k=0; k<P.num_node; k++)
+    {
+        /* N.B. convert from column-major to row-major ordering */
+        P.deg_bdd_vec.push_back(deg_bdd_ptr[k+0*P.num_node]);
+        P.deg_bdd_vec.push_back(deg_bdd_ptr[k+1*P.num_node]);
     }
+}
+/* end mex_read_problem */
 
-    /* optional fourth argument */
-    verbose = 0;
-    if (nrhs > 3) {
-        ii = 3;
-        if (mxGetClassID(prhs[ii])!=mxDOUBLE_CLASS) {
-            mexErrMsgTxt("Could not convert ARG 3 to double.");
-        }
-        if (mxGetNumberOfElements(prhs[ii])!=1) {
-            mexErrMsgTxt("Could not convert ARG 3 to scalar.");
-        }
-        /* */
-        verbose = int(*mxGetPr(prhs[ii]));
-    }
 
+/* solve a problem, without calling the mex API, so that the threads of
+ * a pool can solve problems concurrently; the solver is set up by PP, as
+ * in bmatch */
+static void mex_solve_problem(MexProblem & P, const Parameter & PP, const int & goblin_timers)
+{
+    int             num_ijw;
+    DoubleVec       ijw_vec;
+    AbstractBmatchSolver * ALG;
+
+    /* */
+    P.num_bmatch_edge = 0;
+    P.bmatch_edge_vec.clear();
+    P.bmatch_wgt = -1;
+    P.solve_time = 0.0;
+    num_ijw = P.num_ijw;
 
     /*****************************************************************/
-    /* copy matlab memory into STL vectors */
+    /* bmatch_ijw interface */
     /*****************************************************************/
-    deg_bdd_vec.clear();
-    deg_bdd_vec.reserve(2*num_node);
-    for (k=0; k<num_node; k++)
+    ALG = new_solver(PP.method, PP);
+    P.success = (ALG!=NULL);
+    if (!P.success)
     {
-        /* N.B. convert from column-major to row-major ordering */
-        deg_bdd_vec.push_back(deg_bdd_ptr[k+0*num_node]);
-        deg_bdd_vec.push_back(deg_bdd_ptr[k+1*num_node]);
+        solver_log() << "Method not recognized" << endl;
+        P.method_str = string("Method not recognized");
     }
-    ijw_vec.clear();
-    ijw_vec.reserve(3*num_ijw);
-    for (k=0; k<num_ijw; k++)
+    else if (PP.method==5)
     {
-        /* N.B. convert from column-major to row-major ordering */
-        ijw_vec.push_back(ijw_ptr[k+0*num_ijw]);
-        ijw_vec.push_back(ijw_ptr[k+1*num_ijw]);
-        ijw_vec.push_back(ijw_ptr[k+2*num_ijw]);
-    }
-
-
-    /*****************************************************************/
-    /* bmatch_ijw interface */
-    /*****************************************************************/
-    success = 1;
-    switch (method) {
-        case 1: 
-            ALG = new ComplementaryGoblinExactBmatch();
-            break;
-        case 2: 
-            ALG = new GoblinExactBmatch();
-            break;
-        case 3: 
-            ALG = new GreedyApproxBmatch();
-            break;
-        case 4: 
-            ALG = new RecursiveGreedyApproxBmatch();
-            break;
-        case 5: 
-            ALG = new BeliefPropBmatch();
-            /* use full matrix */
-            ijw_add_upper_tri_transpose(num_ijw, ijw_vec, 1);
-            break;
-        default:
-            cerr << "Method not recognized" << endl;
-            method_str = string("Method not recognized");
-            success = 0;
-            break;
+        /* use full matrix, N.B. a row-major copy */
+        IjwView(P.ijw_ptr, num_ijw).copy(num_ijw, ijw_vec);
+        ijw_add_upper_tri_transpose(num_ijw, ijw_vec, 1);
     }
     /* */
     /* */
-    if (success)
+    if (P.success)
     {
-        method_str = ALG->description();
-        success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+        P.method_str = ALG->description();
+        ALG->seed = (unsigned int)(PP.seed);
+        ALG->profile.goblin_timers = goblin_timers;
+        P.solve_time = wall_clock();
+        if (PP.method==5)
+        {
+            P.success = ALG->solve_bmatching_problem(P.num_node, P.deg_bdd_vec, num_ijw, ijw_vec, P.num_bmatch_edge, P.bmatch_edge_vec, P.bmatch_wgt, PP.verbose);
+        }
+        else
+        {
+            P.success = ALG->solve_bmatching_view(P.num_node, P.deg_bdd_vec, num_ijw, IjwView(P.ijw_ptr, num_ijw), P.num_bmatch_edge, P.bmatch_edge_vec, P.bmatch_wgt, PP.verbose);
+        }
+        P.solve_time = wall_clock() - P.solve_time;
+        P.profile = ALG->profile;
         delete ALG;
     }
     /* */
     /* */
-    if (method==5) /* special case */
+    if (PP.method==5) /* special case */
     {
-        bmatch_wgt = 0.5*bmatch_wgt;
+        P.bmatch_wgt = 0.5*P.bmatch_wgt;
     }
-    /* */
-    /*****************************************************************/
+}
+/* end mex_solve_problem */
 
 
-    /*****************************************************************/
-    /* copy STL vectors into matlab memory */
-    /*****************************************************************/
+/* solve the problems of a pool, until there are none left; the
+ * diagnostics of the solvers, on a thread that is not matlab's, go to the
+ * log of the profile of each problem rather than to cerr */
+static void * mex_thread(void * arg)
+{
+    int         k;
+    MexPool *   pool = (MexPool *)(arg);
+    ostringstream log_strm;
+
+    set_solver_log(&log_strm);
+    while (1)
+    {
+        pthread_mutex_lock(&pool->lock);
+        k = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if (k>=int(pool->problem_vec_ptr->size()))
+        {
+            break;
+        }
+        MexProblem & P = (*pool->problem_vec_ptr)[k];
+
+        log_strm.str("");
+        mex_solve_problem(P, pool->PP, pool->goblin_timers);
+        P.profile.log_str = log_strm.str();
+    }
+    set_solver_log(NULL);
+    return NULL;
+}
+/* end mex_thread */
+
+
+/* the b-matching of a problem, as a NUM_BMATCH_EDGE x 3 matlab array */
+static mxArray * mex_edge_matrix(const MexProblem & P)
+{
+    register int k;
+    mxArray *   arr;
+    double *    bmatch_edge_ptr;
 
     /* could cause trouble if 0 x 3 */
-    plhs[0] = mxCreateDoubleMatrix(num_bmatch_edge, 3, mxREAL);
+    arr = mxCreateDoubleMatrix(P.num_bmatch_edge, 3, mxREAL);
 
     /* copy into matlab memory */
-    if (num_bmatch_edge>0) 
+    if (P.num_bmatch_edge>0)
     {
-        bmatch_edge_ptr = mxGetPr(plhs[0]);
-        for (k=0; k<num_bmatch_edge; k++)
+        bmatch_edge_ptr = mxGetPr(arr);
+        for (k=0; k<P.num_bmatch_edge; k++)
         {
             /* N.B. convert from row-major to column-major ordering */
             /* N.B. convert from _vec to _ptr */
-            bmatch_edge_ptr[k+0*num_bmatch_edge] = bmatch_edge_vec[3*k+0];
-            bmatch_edge_ptr[k+1*num_bmatch_edge] = bmatch_edge_vec[3*k+1];
-            bmatch_edge_ptr[k+2*num_bmatch_edge] = bmatch_edge_vec[3*k+2];
+            bmatch_edge_ptr[k+0*P.num_bmatch_edge] = P.bmatch_edge_vec[3*k+0];
+            bmatch_edge_ptr[k+1*P.num_bmatch_edge] = P.bmatch_edge_vec[3*k+1];
+            bmatch_edge_ptr[k+2*P.num_bmatch_edge] = P.bmatch_edge_vec[3*k+2];
         }
     }
-    /* return weight */
-    if (nlhs > 1) {
-        plhs[1] = mxCreateDoubleMatrix(1, 1, mxREAL);
-        *(mxGetPr(plhs[1])) = bmatch_wgt;
+    return arr;
+}
+/* end mex_edge_matrix */
+
+
+/* scalar optional argument ii, default_val if missing */
+static double mex_scalar_arg(const int & nrhs, const mxArray *prhs[], const int & ii, const double & default_val)
+{
+    ostringstream   arg_strm;
+
+    if (nrhs <= ii) {
+        return default_val;
+    }
+    arg_strm << "ARG " << ii + 1;
+    if (mxGetClassID(prhs[ii])!=mxDOUBLE_CLASS) {
+        mexErrMsgTxt(("Could not convert " + arg_strm.str() + " to double.").c_str());
     }
-    /* return success value */
-    if (nlhs > 2) {
-        plhs[2] = mxCreateDoubleMatrix(1, 1, mxREAL);
-        *(mxGetPr(plhs[2])) = success;
+    if (mxGetNumberOfElements(prhs[ii])!=1) {
+        mexErrMsgTxt(("Could not convert " + arg_strm.str() + " to scalar.").c_str());
+    }
+    return *mxGetPr(prhs[ii]);
+}
+/* end mex_scalar_arg */
+
+
+/* field name of the optional struct argument ii, default_val if the
+ * argument or the field is missing */
+static double mex_option_arg(const int & nrhs, const mxArray *prhs[], const int & ii, const char * name, const double & default_val)
+{
+    ostringstream   arg_strm;
+    const mxArray * field;
+
+    if (nrhs <= ii) {
+        return default_val;
+    }
+    arg_strm << "ARG " << ii + 1;
+    if (!mxIsStruct(prhs[ii]) || (mxGetNumberOfElements(prhs[ii])!=1)) {
+        mexErrMsgTxt(("Could not convert " + arg_strm.str() + " to a struct of options.").c_str());
+    }
+    field = mxGetField(prhs[ii], 0, name);
+    if (field==NULL) {
+        return default_val;
+    }
+    if ((mxGetClassID(field)!=mxDOUBLE_CLASS) || (mxGetNumberOfElements(field)!=1)) {
+        mexErrMsgTxt(("Could not convert " + arg_strm.str() + "." + name + " to a double scalar.").c_str());
+    }
+    return *mxGetPr(field);
+}
+/* end mex_option_arg */
+
+
+/******************************************************************/
+/* Interface for the ijw-based MEX function
+ *
+ * [ijw_out, wgt, success, profile] =
+ *      bmatch_ijw_mex(ijw, deg_bdd, [method], [verbose], [seed], [threads],
+ *          [options])
+ *
+ * options is a struct of the solver options of bmatch, with fields prune,
+ * queue, primal_dual and bipartite (-1 => a 2-colouring, as in bmatch)
+ *
+ * ijw and deg_bdd may be cell arrays of the same size, of problems that
+ * are solved concurrently by a pool of threads (0 => one per core); the
+ * outputs are then a cell array of b-matchings, arrays of weights and
+ * success values, and a cell array of profiles, of the same size; the
+ * goblin methods 1-2 are solved one at a time, under the lock of the exact
+ * solver, and the diagnostics of each solver are the "log" of its profile
+ * */
+/******************************************************************/
+void mexFunction( int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[] )
+{
+    register int    k;
+    int             t;
+
+    Parameter       PP;
+    int             is_cell;
+    int             num_problem;
+
+    vector<MexProblem> problem_vec;
+    MexPool         pool;
+    vector<pthread_t> thread_vec;
+    ostringstream   arg_strm;
+
+    double          total_time;
+    SolveProfile    run_profile;
+    ostringstream   profile_strm;
+
+    /* */
+    total_time = wall_clock();
+    run_profile.start("parse");
+
+    /* one to four outputs */
+    if (nlhs > 4) {
+        mexErrMsgTxt("Too many output arguments.\n");
+    }
+    if (nrhs < 2) {
+        mexErrMsgTxt("Not enough input arguments.\n");
+    }
+
+    /* optional arguments */
+    PP.method = int(mex_scalar_arg(nrhs, prhs, 2, 1));
+    PP.verbose = int(mex_scalar_arg(nrhs, prhs, 3, 0));
+    PP.seed = int(mex_scalar_arg(nrhs, prhs, 4, 0));
+    PP.threads = int(mex_scalar_arg(nrhs, prhs, 5, 0));
+    PP.prune = int(mex_option_arg(nrhs, prhs, 6, "prune", PP.prune));
+    PP.queue = int(mex_option_arg(nrhs, prhs, 6, "queue", PP.queue));
+    PP.primal_dual = int(mex_option_arg(nrhs, prhs, 6, "primal_dual", PP.primal_dual));
+    PP.bipartite = int(mex_option_arg(nrhs, prhs, 6, "bipartite", PP.bipartite));
+
+    /* first and second arguments, a problem or cell arrays of problems */
+    is_cell = int(mxIsCell(prhs[0]));
+    if (is_cell)
+    {
+        if (!mxIsCell(prhs[1]) || (mxGetNumberOfElements(prhs[1])!=mxGetNumberOfElements(prhs[0]))) {
+            mexErrMsgTxt("ARG 2 must be a cell array of the size of ARG 1.");
+        }
+        num_problem = int(mxGetNumberOfElements(prhs[0]));
+        problem_vec.resize(num_problem);
+        for (k=0; k<num_problem; k++)
+        {
+            arg_strm.str("");
+            arg_strm << "{" << k + 1 << "}";
+            if ((mxGetCell(prhs[0], k)==NULL) || (mxGetCell(prhs[1], k)==NULL)) {
+                mexErrMsgTxt(("Empty cell " + arg_strm.str() + " of ARG 1 or ARG 2.").c_str());
+            }
+            mex_read_problem(mxGetCell(prhs[0], k), mxGetCell(prhs[1], k), arg_strm.str(), problem_vec[k]);
+        }
+    }
+    else
+    {
+        num_problem = 1;
+        problem_vec.resize(num_problem);
+        mex_read_problem(prhs[0], prhs[1], "", problem_vec[0]);
+    }
+    run_profile.stop("parse");
+
+
+    /*****************************************************************/
+    /* solve, a problem with the threads of method 6, or the problems of
+     * the cell arrays on a pool of threads, with one thread each */
+    /*****************************************************************/
+    run_profile.start("solve");
+    if (!is_cell)
+    {
+        mex_solve_problem(problem_vec[0], PP, int(nlhs > 3));
+    }
+    else
+    {
+        pool.problem_vec_ptr = &problem_vec;
+        pool.PP = PP;
+        pool.PP.threads = 1;
+        pool.goblin_timers = int(nlhs > 3);
+        pool.num_thread = min(BSuitorApproxBmatch::select_num_thread(PP.threads), max(num_problem, 1));
+        pool.next = 0;
+        pthread_mutex_init(&pool.lock, NULL);
+        thread_vec.resize(pool.num_thread);
+        for (t=0; t<pool.num_thread; t++)
+        {
+            pthread_create(&thread_vec[t], NULL, mex_thread, (void *)(&pool));
+        }
+        for (t=0; t<pool.num_thread; t++)
+        {
+            pthread_join(thread_vec[t], NULL);
+        }
+        pthread_mutex_destroy(&pool.lock);
+    }
+    run_profile.stop("solve");
+    /* */
+    /*****************************************************************/
+
+
+    /*****************************************************************/
+    /* copy STL vectors into matlab memory */
+    /*****************************************************************/
+    run_profile.start("extract");
+    if (!is_cell)
+    {
+        MexProblem & P = problem_vec[0];
+
+        plhs[0] = mex_edge_matrix(P);
+        /* return weight */
+        if (nlhs > 1) {
+            plhs[1] = mxCreateDoubleMatrix(1, 1, mxREAL);
+            *(mxGetPr(plhs[1])) = P.bmatch_wgt;
+        }
+        /* return success value */
+        if (nlhs > 2) {
+            plhs[2] = mxCreateDoubleMatrix(1, 1, mxREAL);
+            *(mxGetPr(plhs[2])) = P.success;
+        }
+        run_profile.stop("extract");
+        /* return JSON solve profile */
+        if (nlhs > 3) {
+            write_solve_json(profile_strm, P.method_str, P.num_node, P.num_ijw, P.num_bmatch_edge, P.bmatch_wgt, P.success, P.solve_time, P.profile, &run_profile);
+            plhs[3] = mxCreateString(profile_strm.str().c_str());
+        }
+    }
+    else
+    {
+        /* outputs of the size of the input cell array */
+        plhs[0] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+        if (nlhs > 1) {
+            plhs[1] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]), mxDOUBLE_CLASS, mxREAL);
+        }
+        if (nlhs > 2) {
+            plhs[2] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]), mxDOUBLE_CLASS, mxREAL);
+        }
+        if (nlhs > 3) {
+            plhs[3] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+        }
+        for (k=0; k<num_problem; k++)
+        {
+            MexProblem & P = problem_vec[k];
+
+            mxSetCell(plhs[0], k, mex_edge_matrix(P));
+            if (nlhs > 1) {
+                mxGetPr(plhs[1])[k] = P.bmatch_wgt;
+            }
+            if (nlhs > 2) {
+                mxGetPr(plhs[2])[k] = P.success;
+            }
+            if (nlhs > 3) {
+                profile_strm.str("");
+                write_solve_json(profile_strm, P.method_str, P.num_node, P.num_ijw, P.num_bmatch_edge, P.bmatch_wgt, P.success, P.solve_time, P.profile);
+                mxSetCell(plhs[3], k, mxCreateString(profile_strm.str().c_str()));
+            }
+            /* the b-matching is in matlab memory now */
+            DoubleVec().swap(P.bmatch_edge_vec);
+        }
+        run_profile.stop("extract");
     }
 
     /* */
-    time2 = time(&time2);
-    total_time = difftime(time2, time1);
+    total_time = wall_clock() - total_time;
 
     /* */
-    if (verbose>0)
+    if (PP.verbose>0)
     {
         cerr << " bmatch done:" << endl;
-        cerr << "       method = " << method_str << endl;
-        cerr << "   in # nodes = " << num_node << endl;
-        cerr << "   in # edges = " << num_ijw << endl;
-        cerr << "  out # edges = " << num_bmatch_edge << endl;
-        cerr << "          wgt = " << bmatch_wgt << endl;
+        if (is_cell)
+        {
+            cerr << "       method = " << PP.method << endl;
+            cerr << "     problems = " << num_problem << endl;
+            cerr << "      threads = " << pool.num_thread << endl;
+        }
+        else
+        {
+            cerr << "       method = " << problem_vec[0].method_str << endl;
+            cerr << "   in # nodes = " << problem_vec[0].num_node << endl;
+            cerr << "   in # edges = " << problem_vec[0].num_ijw << endl;
+            cerr << "  out # edges = " << problem_vec[0].num_bmatch_edge << endl;
+            cerr << "          wgt = " << problem_vec[0].bmatch_wgt << endl;
+        }
         cerr << "  time (sec.) = " << total_time << endl;
+        run_profile.write_summary(cerr);
+        if (!is_cell)
+        {
+            problem_vec[0].profile.write_summary(cerr, "solver ");
+        }
     }
 }
 /* end of mexFunction */
-
-
@@ -0,0 +1,487 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ *
+ * Python extension module bmatch
+ *
+ *   edges, wgt, success[, profile] = bmatch.solve(ijw, deg_bdd, method=1,
+ *       verbose=0, seed=0, threads=0, profile=0, prune=0, queue=-1,
+ *       primal_dual=-1, bipartite=-1)
+ *   edges, wgt, success[, profile] = bmatch.solve_coo(row, col, data,
+ *       deg_bdd, ...)
+ *
+ * ijw is an N x 3 float64 array [i, j, w] of 0-based nodes, in either order
+ * and with any strides, and deg_bdd an n x 2 float64 array [l, u], read in
+ * place through the buffer protocol (e.g. numpy arrays); solve_coo takes
+ * the row, col and data arrays of a scipy.sparse.coo_matrix, whose indices
+ * are converted to doubles; the solvers are set up as in bmatch, by its
+ * options of the same names
+ *
+ * the GIL is released while solving, so that threads of the caller can
+ * solve concurrently, but for the goblin solves of methods 1-2, which run
+ * one at a time under the lock of the exact solver; edges is a float64 array [i, j, w] of the b-matching,
+ * a numpy array if numpy can be imported and a memoryview otherwise, that
+ * reads the solver output in place
+ * */
+#include <Python.h>
+#include <string>
+#include <sstream>
+using namespace std;
+#include <cstring>
+#include <cctype>
+#include "Vector.hpp"
+#include "AbstractBmatchSolver.hpp"
+#include "newsolver.hpp"
+
+
+/* a b-matching, num_bmatch_edge x 3 in row-major order, exported through
+ * the buffer protocol */
+typedef struct
+{
+    PyObject_HEAD
+    DoubleVec * edge_vec_ptr;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+} PyBmatchEdges;
+
+
+/* */
+static void py_edges_dealloc(PyBmatchEdges * self)
+{
+    delete self->edge_vec_ptr;
+    Py_TYPE(self)->tp_free((PyObject *)(self));
+}
+/* end py_edges_dealloc */
+
+
+/* read-only 2-d float64 buffer of the b-matching */
+static int py_edges_getbuffer(PyBmatchEdges * self, Py_buffer * view, int flags)
+{
+    if (flags & PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "bmatch edges are read-only");
+        view->obj = NULL;
+        return -1;
+    }
+    view->obj = (PyObject *)(self);
+    Py_INCREF(view->obj);
+    view->buf = self->edge_vec_ptr->empty() ? NULL : (void *)(&(*self->edge_vec_ptr)[0]);
+    view->len = Py_ssize_t(self->edge_vec_ptr->size()*sizeof(double));
+    view->readonly = 1;
+    view->itemsize = sizeof(double);
+    view->format = (flags & PyBUF_FORMAT) ? (char *)("d") : NULL;
+    view->ndim = 2;
+    view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+    view->strides = ((flags & PyBUF_STRIDES)==PyBUF_STRIDES) ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+/* end py_edges_getbuffer */
+
+
+static PyBufferProcs py_edges_as_buffer = {
+    (getbufferproc)(py_edges_getbuffer),
+    NULL
+};
+
+static PyTypeObject PyBmatchEdgesType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "bmatch.Edges",                             /* tp_name */
+    sizeof(PyBmatchEdges),                      /* tp_basicsize */
+};
+
+
+/* wrap a b-matching, taking its vector; numpy array if numpy can be
+ * imported, memoryview otherwise */
+static PyObject * py_edges_array(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec)
+{
+    PyBmatchEdges * edges;
+    PyObject *      numpy;
+    PyObject *      arr;
+
+    edges = PyObject_New(PyBmatchEdges, &PyBmatchEdgesType);
+    if (edges==NULL)
+    {
+        return NULL;
+    }
+    edges->edge_vec_ptr = new DoubleVec();
+    edges->edge_vec_ptr->swap(bmatch_edge_vec);
+    edges->shape[0] = num_bmatch_edge;
+    edges->shape[1] = 3;
+    edges->strides[0] = 3*sizeof(double);
+    edges->strides[1] = sizeof(double);
+
+    numpy = PyImport_ImportModule("numpy");
+    if (numpy==NULL)
+    {
+        PyErr_Clear();
+        arr = PyMemoryView_FromObject((PyObject *)(edges));
+    }
+    else
+    {
+        arr = PyObject_CallMethod(numpy, "asarray", "O", (PyObject *)(edges));
+        Py_DECREF(numpy);
+    }
+    Py_DECREF(edges);
+    return arr;
+}
+/* end py_edges_array */
+
+
+/* native float64 (or integer, if is_index) format of a buffer */
+static int py_is_format(const char * format, const int & is_index)
+{
+    if ((format==NULL) || (format[0]=='\0'))
+    {
+        return is_index;        /* unsigned bytes */
+    }
+    if (strchr("@=<", format[0]))
+    {
+        format++;
+    }
+    if ((format[0]=='\0') || (format[1]!='\0'))
+    {
+        return 0;
+    }
+    return (is_index ? (strchr("bBhHiIlLqQd", format[0])!=NULL) : (format[0]=='d'));
+}
+/* end py_is_format */
+
+
+/* get a num_dim read-only buffer of float64 (or integers, if is_index),
+ * with num_col columns if num_dim is 2; returns 0 with a Python
+ * exception set otherwise */
+static int py_get_buffer(PyObject * obj, const char * name, const int & num_dim, const int & num_col, const int & is_index, Py_buffer & view)
+{
+    if (PyObject_GetBuffer(obj, &view, PyBUF_RECORDS_RO)!=0)
+    {
+        return 0;
+    }
+    if (!py_is_format(view.format, is_index) || (view.ndim!=num_dim) || ((num_dim==2) && ((view.shape[1]!=num_col)
+        || (view.strides[0]%Py_ssize_t(sizeof(double))) || (view.strides[1]%Py_ssize_t(sizeof(double))))))
+    {
+        if (num_dim==2)
+        {
+            PyErr_Format(PyExc_ValueError, "%s must be an N x %d float64 array", name, num_col);
+        }
+        else
+        {
+            PyErr_Format(PyExc_ValueError, "%s must be a 1-d %s array", name, (is_index ? "integer" : "float64"));
+        }
+        PyBuffer_Release(&view);
+        return 0;
+    }
+    return 1;
+}
+/* end py_get_buffer */
+
+
+/* element k of a 1-d integer or float64 buffer, as a double; integers
+ * are read by their size, signed if their format is lower case */
+static double py_buffer_value(const Py_buffer & view, const Py_ssize_t & k)
+{
+    const char * ptr = (const char *)(view.buf) + k*view.strides[0];
+    char         c = (view.format==NULL) ? 'B' : view.format[strlen(view.format)-1];
+
+    if (c=='d')
+    {
+        return *(const double *)(ptr);
+    }
+    if (islower(c))
+    {
+        switch (view.itemsize)
+        {
+            case 1: return double(*(const signed char *)(ptr));
+            case 2: return double(*(const short *)(ptr));
+            case 4: return double(*(const int *)(ptr));
+        }
+        return double(*(const long long *)(ptr));
+    }
+    switch (view.itemsize)
+    {
+        case 1: return double(*(const unsigned char *)(ptr));
+        case 2: return double(*(const unsigned short *)(ptr));
+        case 4: return double(*(const unsigned int *)(ptr));
+    }
+    return double(*(const unsigned long long *)(ptr));
+}
+/* end py_buffer_value */
+
+
+/* solve the b-matching problem of an ijw view and an n x 2 degree bounds
+ * buffer, without the GIL, and build the result tuple */
+static PyObject * py_solve_view(const int & num_ijw, const IjwView & ijw_view, const Py_buffer & deg_view, const Parameter & PP, const int & is_profile)
+{
+    register int    k;
+    int             num_node;
+    DoubleVec       deg_bdd_vec;
+    int             L_num_ijw;
+    DoubleVec       ijw_vec;
+    int             success;
+    int             num_bmatch_edge;
+    DoubleVec       bmatch_edge_vec;
+    double          bmatch_wgt;
+    double          solve_time;
+    string          method_str;
+    ostringstream   profile_strm;
+    AbstractBmatchSolver * ALG;
+    PyObject *      edges;
+
+    /* nodes, 0-based */
+    num_node = 0;
+    for (k=0; k<num_ijw; k++)
+    {
+        if ((ijw_view.i(k)<0) || (ijw_view.j(k)<0))
+        {
+            PyErr_SetString(PyExc_ValueError, "nodes of ijw must be 0-based");
+            return NULL;
+        }
+        num_node = max(num_node, 1 + int(max(ijw_view.i(k), ijw_view.j(k))));
+    }
+    if (deg_view.shape[0]<num_node)
+    {
+        PyErr_SetString(PyExc_ValueError, "deg_bdd must have a row per node of ijw");
+        return NULL;
+    }
+    num_node = int(deg_view.shape[0]);
+
+    /* copy the degree bounds into STL vectors */
+    deg_bdd_vec.resize(2*num_node);
+    for (k=0; k<num_node; k++)
+    {
+        deg_bdd_vec[2*k+0] = *(const double *)((const char *)(deg_view.buf) + k*deg_view.strides[0]);
+        deg_bdd_vec[2*k+1] = *(const double *)((const char *)(deg_view.buf) + k*deg_view.strides[0] + deg_view.strides[1]);
+    }
+
+    /* */
+    ALG = new_solver(PP.method, PP);
+    if (ALG==NULL)
+    {
+        PyErr_Format(PyExc_ValueError, "method %d not recognized", PP.method);
+        return NULL;
+    }
+    method_str = ALG->description();
+    ALG->seed = (unsigned int)(PP.seed);
+    ALG->profile.goblin_timers = is_profile;
+
+    /* solve, without the GIL */
+    num_bmatch_edge = 0;
+    bmatch_wgt = -1;
+    Py_BEGIN_ALLOW_THREADS
+    solve_time = wall_clock();
+    if (PP.method==5)
+    {
+        /* use full matrix, N.B. a row-major copy */
+        L_num_ijw = num_ijw;
+        ijw_view.copy(L_num_ijw, ijw_vec);
+        ijw_add_upper_tri_transpose(L_num_ijw, ijw_vec, 1);
+        success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, L_num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, PP.verbose);
+        bmatch_wgt = 0.5*bmatch_wgt;
+    }
+    else
+    {
+        success = ALG->solve_bmatching_view(num_node, deg_bdd_vec, num_ijw, ijw_view, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, PP.verbose);
+    }
+    solve_time = wall_clock() - solve_time;
+    if (is_profile)
+    {
+        write_solve_json(profile_strm, method_str, num_node, num_ijw, num_bmatch_edge, bmatch_wgt, success, solve_time, ALG->profile);
+    }
+    /* N.B. the goblin solvers take the goblin lock to delete their graph */
+    delete ALG;
+    Py_END_ALLOW_THREADS
+
+    /* */
+    edges = py_edges_array(num_bmatch_edge, bmatch_edge_vec);
+    if (edges==NULL)
+    {
+        return NULL;
+    }
+    if (is_profile)
+    {
+        return Py_BuildValue("(Ndis)", edges, bmatch_wgt, success, profile_strm.str().c_str());
+    }
+    return Py_BuildValue("(Ndi)", edges, bmatch_wgt, success);
+}
+/* end py_solve_view */
+
+
+/* bmatch.solve */
+static PyObject * py_solve(PyObject * self, PyObject * args, PyObject * kwds)
+{
+    static char *   kwlist[] = {(char *)"ijw", (char *)"deg_bdd", (char *)"method", (char *)"verbose", (char *)"seed", (char *)"threads", (char *)"profile", (char *)"prune", (char *)"queue", (char *)"primal_dual", (char *)"bipartite", NULL};
+    PyObject *      ijw_obj;
+    PyObject *      deg_obj;
+    unsigned int    seed = 0;
+    int             is_profile = 0;
+    Parameter       PP;
+    Py_buffer       ijw_view;
+    Py_buffer       deg_view;
+    const double *  ijw_ptr;
+    Py_ssize_t      rs;
+    Py_ssize_t      cs;
+    PyObject *      result;
+
+    PP.method = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|iiIiiiiii", kwlist, &ijw_obj, &deg_obj, &PP.method, &PP.verbose, &seed, &PP.threads, &is_profile, &PP.prune, &PP.queue, &PP.primal_dual, &PP.bipartite))
+    {
+        return NULL;
+    }
+    PP.seed = int(seed);
+    if (!py_get_buffer(ijw_obj, "ijw", 2, 3, 0, ijw_view))
+    {
+        return NULL;
+    }
+    if (!py_get_buffer(deg_obj, "deg_bdd", 2, 2, 0, deg_view))
+    {
+        PyBuffer_Release(&ijw_view);
+        return NULL;
+    }
+
+    /* the columns of ijw, read in place */
+    ijw_ptr = (const double *)(ijw_view.buf);
+    rs = ijw_view.strides[0]/Py_ssize_t(sizeof(double));
+    cs = ijw_view.strides[1]/Py_ssize_t(sizeof(double));
+    result = py_solve_view(int(ijw_view.shape[0]), IjwView(ijw_ptr, ijw_ptr + cs, ijw_ptr + 2*cs, int(rs)), deg_view, PP, is_profile);
+
+    PyBuffer_Release(&deg_view);
+    PyBuffer_Release(&ijw_view);
+    return result;
+}
+/* end py_solve */
+
+
+/* bmatch.solve_coo */
+static PyObject * py_solve_coo(PyObject * self, PyObject * args, PyObject * kwds)
+{
+    static char *   kwlist[] = {(char *)"row", (char *)"col", (char *)"data", (char *)"deg_bdd", (char *)"method", (char *)"verbose", (char *)"seed", (char *)"threads", (char *)"profile", (char *)"prune", (char *)"queue", (char *)"primal_dual", (char *)"bipartite", NULL};
+    register Py_ssize_t k;
+    PyObject *      row_obj;
+    PyObject *      col_obj;
+    PyObject *      data_obj;
+    PyObject *      deg_obj;
+    unsigned int    seed = 0;
+    int             is_profile = 0;
+    Parameter       PP;
+    Py_buffer       row_view;
+    Py_buffer       col_view;
+    Py_buffer       data_view;
+    Py_buffer       deg_view;
+    Py_ssize_t      num_ijw;
+    DoubleVec       col_vec;
+    PyObject *      result;
+
+    PP.method = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|iiIiiiiii", kwlist, &row_obj, &col_obj, &data_obj, &deg_obj, &PP.method, &PP.verbose, &seed, &PP.threads, &is_profile, &PP.prune, &PP.queue, &PP.primal_dual, &PP.bipartite))
+    {
+        return NULL;
+    }
+    PP.seed = int(seed);
+    if (!py_get_buffer(row_obj, "row", 1, 0, 1, row_view))
+    {
+        return NULL;
+    }
+    if (!py_get_buffer(col_obj, "col", 1, 0, 1, col_view))
+    {
+        PyBuffer_Release(&row_view);
+        return NULL;
+    }
+    if (!py_get_buffer(data_obj, "data", 1, 0, 0, data_view))
+    {
+        PyBuffer_Release(&col_view);
+        PyBuffer_Release(&row_view);
+        return NULL;
+    }
+    if (!py_get_buffer(deg_obj, "deg_bdd", 2, 2, 0, deg_view))
+    {
+        PyBuffer_Release(&data_view);
+        PyBuffer_Release(&col_view);
+        PyBuffer_Release(&row_view);
+        return NULL;
+    }
+    num_ijw = data_view.shape[0];
+    if ((row_view.shape[0]!=num_ijw) || (col_view.shape[0]!=num_ijw))
+    {
+        PyErr_SetString(PyExc_ValueError, "row, col and data must have the same length");
+        result = NULL;
+    }
+    else
+    {
+        /* the indices as doubles, and the data in place when contiguous */
+        col_vec.resize(3*num_ijw);
+        for (k=0; k<num_ijw; k++)
+        {
+            col_vec[k] = py_buffer_value(row_view, k);
+            col_vec[num_ijw + k] = py_buffer_value(col_view, k);
+        }
+        if ((data_view.strides[0]==Py_ssize_t(sizeof(double))) && (num_ijw>0))
+        {
+            result = py_solve_view(int(num_ijw), IjwView(&col_vec[0], &col_vec[num_ijw], (const double *)(data_view.buf), 1), deg_view, PP, is_profile);
+        }
+        else
+        {
+            for (k=0; k<num_ijw; k++)
+            {
+                col_vec[2*num_ijw + k] = py_buffer_value(data_view, k);
+            }
+            result = py_solve_view(int(num_ijw), IjwView(col_vec.empty() ? NULL : &col_vec[0], int(num_ijw)), deg_view, PP, is_profile);
+        }
+    }
+
+    PyBuffer_Release(&deg_view);
+    PyBuffer_Release(&data_view);
+    PyBuffer_Release(&col_view);
+    PyBuffer_Release(&row_view);
+    return result;
+}
+/* end py_solve_coo */
+
+
+static PyMethodDef py_bmatch_methods[] = {
+    {"solve", (PyCFunction)(void (*)(void))(py_solve), METH_VARARGS | METH_KEYWORDS,
+        "solve(ijw, deg_bdd, method=1, verbose=0, seed=0, threads=0, profile=0,\n"
+        "      prune=0, queue=-1, primal_dual=-1, bipartite=-1)\n\n"
+        "b-matching of an N x 3 float64 array [i, j, w] of 0-based nodes, with\n"
+        "an n x 2 float64 array [l, u] of degree bounds, both read in place;\n"
+        "returns (edges, wgt, success), and the JSON solve profile if profile;\n"
+        "prune, queue, primal_dual and bipartite are the options of bmatch"},
+    {"solve_coo", (PyCFunction)(void (*)(void))(py_solve_coo), METH_VARARGS | METH_KEYWORDS,
+        "solve_coo(row, col, data, deg_bdd, method=1, verbose=0, seed=0, threads=0,\n"
+        "          profile=0, prune=0, queue=-1, primal_dual=-1, bipartite=-1)\n\n"
+        "as solve, for the row, col and data arrays of a coo_matrix"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef py_bmatch_module = {
+    PyModuleDef_HEAD_INIT,
+    "bmatch",
+    "B-matching toolbox: weighted b-matching solvers",
+    -1,
+    py_bmatch_methods
+};
+
+
+/* */
+PyMODINIT_FUNC PyInit_bmatch(void)
+{
+    PyObject * module;
+
+    PyBmatchEdgesType.tp_dealloc = (destructor)(py_edges_dealloc);
+    PyBmatchEdgesType.tp_as_buffer = &py_edges_as_buffer;
+    PyBmatchEdgesType.tp_flags = Py_TPFLAGS_DEFAULT;
+    PyBmatchEdgesType.tp_doc = "b-matching edges, read through the buffer protocol";
+    if (PyType_Ready(&PyBmatchEdgesType)<0)
+    {
+        return NULL;
+    }
+    module = PyModule_Create(&py_bmatch_module);
+    if (module==NULL)
+    {
+        return NULL;
+    }
+    Py_INCREF(&PyBmatchEdgesType);
+    PyModule_AddObject(module, "Edges", (PyObject *)(&PyBmatchEdgesType));
+    return module;
+}
+/* end PyInit_bmatch */
@@ -0,0 +1,640 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ *
+ * b-matching server on a Unix domain socket, see bmatch_server.hpp
+ * */
+#include <sstream>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <new>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "bmatch_server.hpp"
+#include "bsuitor.hpp"
+#include "autoselect.hpp"
+#include "newsolver.hpp"
+
+
+/* refill the buffer; returns 0 at the end */
+int ServerConn::
+fill()
+{
+    ssize_t len;
+
+    if (begin<end)
+    {
+        return 1;
+    }
+    do
+    {
+        len = read(fd, &buf_vec[0], buf_vec.size());
+    } while ((len<0) && (errno==EINTR));
+    begin = 0;
+    end = (len>0) ? size_t(len) : 0;
+    return (len>0);
+}
+/* end fill */
+
+
+/* next line, without its newline; returns 0 at the end */
+int ServerConn::
+read_line(string & line)
+{
+    size_t k;
+
+    line.clear();
+    while (fill())
+    {
+        for (k=begin; k<end; k++)
+        {
+            if (buf_vec[k]=='\n')
+            {
+                line.append(&buf_vec[begin], k - begin);
+                begin = k + 1;
+                return 1;
+            }
+        }
+        line.append(&buf_vec[begin], end - begin);
+        begin = end;
+        if (line.size()>SERVER_BUFFER_SIZE)
+        {
+            /* not a request */
+            return 0;
+        }
+    }
+    return (line.size()>0);
+}
+/* end read_line */
+
+
+/* num numbers as text, separated by white space */
+int ServerConn::
+read_text(const int & num, DoubleVec & val_vec)
+{
+    register int k;
+    int         len;
+    char        token[64];
+    char        * end_ptr;
+    char        c;
+
+    val_vec.resize(num);
+    for (k=0; k<num; k++)
+    {
+        /* skip white space */
+        while (1)
+        {
+            if (!fill())
+            {
+                return 0;
+            }
+            c = buf_vec[begin];
+            if ((c!=' ') && (c!='\t') && (c!='\n') && (c!='\r'))
+            {
+                break;
+            }
+            begin++;
+        }
+        /* token */
+        len = 0;
+        while (fill())
+        {
+            c = buf_vec[begin];
+            if ((c==' ') || (c=='\t') || (c=='\n') || (c=='\r'))
+            {
+                break;
+            }
+            if (len+1>=int(sizeof(token)))
+            {
+                return 0;
+            }
+            token[len++] = c;
+            begin++;
+        }
+        token[len] = '\0';
+        val_vec[k] = strtod(token, &end_ptr);
+        if (*end_ptr!='\0')
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+/* end read_text */
+
+
+/* num native doubles */
+int ServerConn::
+read_binary(const int & num, DoubleVec & val_vec)
+{
+    size_t  len;
+    size_t  total = sizeof(double)*size_t(num);
+    char    * ptr;
+
+    val_vec.resize(num);
+    if (num==0)
+    {
+        return 1;
+    }
+    ptr = (char *)(&val_vec[0]);
+    while (total>0)
+    {
+        if (!fill())
+        {
+            return 0;
+        }
+        len = min(total, end - begin);
+        memcpy(ptr, &buf_vec[begin], len);
+        begin += len;
+        ptr += len;
+        total -= len;
+    }
+    return 1;
+}
+/* end read_binary */
+
+
+/* write len bytes; returns 0 if the client went away */
+int ServerConn::
+write_all(const char * ptr, const size_t & len)
+{
+    size_t  done = 0;
+    ssize_t num;
+
+    while (done<len)
+    {
+        num = write(fd, ptr + done, len - done);
+        if (num<0)
+        {
+            if (errno==EINTR)
+            {
+                continue;
+            }
+            return 0;
+        }
+        done += size_t(num);
+    }
+    return 1;
+}
+/* end write_all */
+
+
+/* constructor */
+BmatchServer::
+BmatchServer(const Parameter & in_PP) : PP(in_PP), listen_fd(-1), is_stopped(0)
+{
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+/* end BmatchServer */
+
+
+/* destructor */
+BmatchServer::
+~BmatchServer()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+/* end ~BmatchServer */
+
+
+/* answer a solve request */
+int BmatchServer::
+solve(ServerConn & conn, const string & line, vector<AbstractBmatchSolver *> & solver_vec, string & error_str)
+{
+    register int k;
+    string      cmd;
+    string      format;
+    int         method = 0;
+    int         num_node = -1;
+    int         num_ijw = -1;
+    int         is_binary;
+    int         success;
+    int         num_bmatch_edge = 0;
+    double      bmatch_wgt = 0.0;
+    double      solve_time;
+    DoubleVec   ijw_vec;
+    DoubleVec   deg_bdd_vec;
+    DoubleVec   bmatch_edge_vec;
+    AbstractBmatchSolver * ALG = NULL;
+    istringstream in_strm(line);
+    ostringstream out_strm;
+    string      out_str;
+    char        edge_str[96];
+    int         len;
+    double      budget = 1048576.0*((PP.max_mem>0) ? PP.max_mem : SERVER_MAX_MEM);
+
+    /* header */
+    in_strm >> cmd >> method >> format >> num_node >> num_ijw;
+    if (in_strm.fail() || (num_node<0) || (num_node>SERVER_MAX_NODE) || (num_ijw<0) || (num_ijw>SERVER_MAX_IJW))
+    {
+        error_str = "malformed solve request";
+        return 0;
+    }
+    if ((method<0) || (method>SERVER_NUM_METHOD))
+    {
+        error_str = "method not recognized";
+        return 0;
+    }
+    if ((format!="ijw") && (format!="binary"))
+    {
+        error_str = "format must be ijw or binary";
+        return 0;
+    }
+    is_binary = (format=="binary");
+
+    /* the request buffers, before they are allocated */
+    if (24.0*double(num_ijw) + 16.0*double(num_node)>budget)
+    {
+        error_str = "over -max_mem";
+        return 0;
+    }
+
+    /* warm solver of the method, within the memory budget, checked before
+     * the edges are read unless the method is chosen from them; each worker
+     * has its own, and the goblin methods 1-2 serialize their solves */
+    if (method>0)
+    {
+        if (solver_vec[method]==NULL)
+        {
+            solver_vec[method] = new_solver(method, PP);
+        }
+        ALG = solver_vec[method];
+        if (ALG->memory_estimate(num_node, (method==5) ? 2*num_ijw : num_ijw)>budget)
+        {
+            error_str = "over -max_mem";
+            return 0;
+        }
+    }
+
+    /* edges and degree bounds */
+    if (is_binary)
+    {
+        success = conn.read_binary(3*num_ijw, ijw_vec) && conn.read_binary(2*num_node, deg_bdd_vec);
+    }
+    else
+    {
+        success = conn.read_text(3*num_ijw, ijw_vec) && conn.read_text(2*num_node, deg_bdd_vec);
+    }
+    if (!success)
+    {
+        error_str = "edges or degree bounds cut short";
+        return 0;
+    }
+    for (k=0; k<num_ijw; k++)
+    {
+        if ((ijw_vec[3*k+0]<0) || (ijw_vec[3*k+0]>=num_node) || (ijw_vec[3*k+0]!=floor(ijw_vec[3*k+0])) ||
+            (ijw_vec[3*k+1]<0) || (ijw_vec[3*k+1]>=num_node) || (ijw_vec[3*k+1]!=floor(ijw_vec[3*k+1])))
+        {
+            error_str = "edge node out of range";
+            return 0;
+        }
+    }
+
+    /* fastest method of the required accuracy */
+    if (method==0)
+    {
+        method = select_method(num_node, deg_bdd_vec, num_ijw, IjwView(ijw_vec), PP.accuracy, budget/1048576.0, BSuitorApproxBmatch::select_num_thread(PP.threads), (PP.verbose>1) ? &out_strm : NULL);
+        if (PP.verbose>1)
+        {
+            pthread_mutex_lock(&lock);
+            cerr << out_strm.str();
+            pthread_mutex_unlock(&lock);
+            out_strm.str("");
+        }
+        if (solver_vec[method]==NULL)
+        {
+            solver_vec[method] = new_solver(method, PP);
+        }
+        ALG = solver_vec[method];
+        if (ALG->memory_estimate(num_node, num_ijw)>budget)
+        {
+            error_str = "over -max_mem";
+            return 0;
+        }
+    }
+
+    ALG->profile.clear();
+    ALG->seed = (unsigned int)(PP.seed);
+    if (method==5)
+    {
+        /* use full matrix */
+        ijw_add_upper_tri_transpose(num_ijw, ijw_vec, 1);
+    }
+    solve_time = wall_clock();
+    success = ALG->solve_bmatching_problem(num_node, deg_bdd_vec, num_ijw, ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, max(PP.verbose-1, 0));
+    solve_time = wall_clock() - solve_time;
+    if (method==5) /* special case */
+    {
+        bmatch_wgt = 0.5*bmatch_wgt;
+    }
+
+    /* answer */
+    out_strm.precision(17);
+    out_strm << "ok " << success << " " << num_bmatch_edge << " " << bmatch_wgt << " " << solve_time << "\n";
+    out_str = out_strm.str();
+    if (is_binary)
+    {
+        out_str.append((const char *)(num_bmatch_edge>0 ? &bmatch_edge_vec[0] : NULL), sizeof(double)*3*size_t(num_bmatch_edge));
+    }
+    else
+    {
+        out_str.reserve(out_str.size() + 32*size_t(num_bmatch_edge));
+        for (k=0; k<num_bmatch_edge; k++)
+        {
+            len = snprintf(edge_str, sizeof(edge_str), "%d %d %.17g\n", int(bmatch_edge_vec[3*k+0]), int(bmatch_edge_vec[3*k+1]), bmatch_edge_vec[3*k+2]);
+            out_str.append(edge_str, len);
+        }
+    }
+    if (!conn.write_all(out_str.data(), out_str.size()))
+    {
+        error_str = "client went away";
+        return 0;
+    }
+
+    if (PP.verbose>0)
+    {
+        out_strm.str("");
+        out_strm.precision(4);
+        out_strm << "bmatch serve> method " << method << ", " << num_node << " nodes, " << num_ijw << " edges, ";
+        out_strm << num_bmatch_edge << " matched, wgt " << bmatch_wgt << ", " << solve_time << " sec." << endl;
+        pthread_mutex_lock(&lock);
+        cerr << out_strm.str();
+        pthread_mutex_unlock(&lock);
+    }
+    return 1;
+}
+/* end solve */
+
+
+/* serve the requests of a connection */
+void BmatchServer::
+serve(ServerConn & conn, vector<AbstractBmatchSolver *> & solver_vec)
+{
+    register int k;
+    string  line;
+    string  cmd;
+    string  error_str;
+
+    while (conn.read_line(line))
+    {
+        istringstream in_strm(line);
+        cmd.clear();
+        in_strm >> cmd;
+        if (cmd=="solve")
+        {
+            /* a request that runs out of memory fails alone; the warm
+             * solvers are dropped, as their state is unknown */
+            try
+            {
+                if (!solve(conn, line, solver_vec, error_str))
+                {
+                    break;
+                }
+            }
+            catch (bad_alloc &)
+            {
+                for (k=0; k<int(solver_vec.size()); k++)
+                {
+                    delete solver_vec[k];
+                    solver_vec[k] = NULL;
+                }
+                error_str = "out of memory";
+                break;
+            }
+        }
+        else if (cmd=="ping")
+        {
+            if (!conn.write_all("pong\n", 5))
+            {
+                return;
+            }
+        }
+        else if (cmd=="shutdown")
+        {
+            conn.write_all("ok\n", 3);
+            stop();
+            return;
+        }
+        else if (cmd.size()>0)
+        {
+            error_str = "unknown request " + cmd;
+            break;
+        }
+    }
+    if (error_str.size()>0)
+    {
+        error_str = "error " + error_str + "\n";
+        conn.write_all(error_str.data(), error_str.size());
+        if (PP.verbose>0)
+        {
+            pthread_mutex_lock(&lock);
+            cerr << "bmatch serve!> " << error_str;
+            pthread_mutex_unlock(&lock);
+        }
+    }
+}
+/* end serve */
+
+
+/* worker thread entry point */
+void * BmatchServer::
+run_worker(void * arg)
+{
+    ((BmatchServer *)arg)->work();
+    return NULL;
+}
+/* end run_worker */
+
+
+/* take connections from the queue until the server stops */
+void BmatchServer::
+work()
+{
+    register int k;
+    int fd;
+    vector<AbstractBmatchSolver *> solver_vec(SERVER_NUM_METHOD+1, (AbstractBmatchSolver *)NULL);
+
+    while (1)
+    {
+        pthread_mutex_lock(&lock);
+        while (conn_queue.empty() && !is_stopped)
+        {
+            pthread_cond_wait(&cond, &lock);
+        }
+        if (is_stopped)
+        {
+            pthread_mutex_unlock(&lock);
+            break;
+        }
+        fd = conn_queue.front();
+        conn_queue.pop_front();
+        active_set.insert(fd);
+        pthread_mutex_unlock(&lock);
+
+        ServerConn conn(fd);
+        serve(conn, solver_vec);
+
+        pthread_mutex_lock(&lock);
+        active_set.erase(fd);
+        pthread_mutex_unlock(&lock);
+        close(fd);
+    }
+
+    for (k=0; k<=SERVER_NUM_METHOD; k++)
+    {
+        delete solver_vec[k];
+    }
+}
+/* end work */
+
+
+/* stop accepting, and end the connections being served */
+void BmatchServer::
+stop()
+{
+    int fd;
+    struct sockaddr_un addr;
+    set<int>::iterator it;
+
+    pthread_mutex_lock(&lock);
+    if (is_stopped)
+    {
+        pthread_mutex_unlock(&lock);
+        return;
+    }
+    is_stopped = 1;
+    for (it=active_set.begin(); it!=active_set.end(); it++)
+    {
+        shutdown(*it, SHUT_RD);
+    }
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    /* wake the accepting thread with a connection of our own */
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, PP.serve.c_str(), sizeof(addr.sun_path) - 1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd>=0)
+    {
+        connect(fd, (struct sockaddr *)(&addr), sizeof(addr));
+        close(fd);
+    }
+}
+/* end stop */
+
+
+/* listen on PP.serve, and serve until a shutdown request */
+int BmatchServer::
+run()
+{
+    register int t;
+    int         fd;
+    int         num_worker;
+    struct sockaddr_un addr;
+    struct stat st;
+    vector<pthread_t> thread_vec;
+    vector<int> created_vec;
+
+    /* a client that goes away must not kill the server */
+    signal(SIGPIPE, SIG_IGN);
+
+    if (PP.serve.size()>=sizeof(addr.sun_path))
+    {
+        cerr << "bmatch serve!> socket path too long: " << PP.serve << endl;
+        return 1;
+    }
+    /* the socket of a previous server */
+    if ((stat(PP.serve.c_str(), &st)==0) && S_ISSOCK(st.st_mode))
+    {
+        unlink(PP.serve.c_str());
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, PP.serve.c_str(), sizeof(addr.sun_path) - 1);
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((listen_fd<0) || (bind(listen_fd, (struct sockaddr *)(&addr), sizeof(addr))!=0) || (listen(listen_fd, SOMAXCONN)!=0))
+    {
+        cerr << "bmatch serve!> can not listen on " << PP.serve << ": " << strerror(errno) << endl;
+        if (listen_fd>=0)
+        {
+            close(listen_fd);
+        }
+        return 1;
+    }
+
+    /* workers */
+    num_worker = (PP.workers>0) ? PP.workers : BSuitorApproxBmatch::select_num_thread(0);
+    thread_vec.resize(num_worker);
+    created_vec.assign(num_worker, 0);
+    for (t=0; t<num_worker; t++)
+    {
+        created_vec[t] = (pthread_create(&thread_vec[t], NULL, &BmatchServer::run_worker, this)==0);
+    }
+    cerr << "bmatch serve> listening on " << PP.serve << " with " << num_worker << " workers" << endl;
+
+    /* accept */
+    while (1)
+    {
+        fd = accept(listen_fd, NULL, NULL);
+        if (fd<0)
+        {
+            if (errno==EINTR)
+            {
+                continue;
+            }
+            cerr << "bmatch serve!> accept: " << strerror(errno) << endl;
+            stop();
+            break;
+        }
+        pthread_mutex_lock(&lock);
+        if (is_stopped)
+        {
+            pthread_mutex_unlock(&lock);
+            close(fd);
+            break;
+        }
+        conn_queue.push_back(fd);
+        pthread_cond_signal(&cond);
+        pthread_mutex_unlock(&lock);
+    }
+
+    for (t=0; t<num_worker; t++)
+    {
+        if (created_vec[t])
+        {
+            pthread_join(thread_vec[t], NULL);
+        }
+    }
+    while (!conn_queue.empty())
+    {
+        close(conn_queue.front());
+        conn_queue.pop_front();
+    }
+    close(listen_fd);
+    unlink(PP.serve.c_str());
+    cerr << "bmatch serve> stopped" << endl;
+    return 0;
+}
+/* end run */
+
+
+/* serve b-matching requests on the socket PP.serve, see BmatchServer */
+int serve_bmatch(const Parameter & PP)
+{
+    BmatchServer server(PP);
+    return server.run();
+}
+/* end serve_bmatch */
+
@@ -0,0 +1,491 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <algorithm>
+#include <unistd.h>
+#include "bsuitor.hpp"
+
+
+/* edge e1 before edge e2: heavier, or as heavy with a lower rank */
+class bsuitor_edge_before
+{
+    public:
+        bsuitor_edge_before(const DoubleVec & in_edge_wgt_vec, const vector<int> & in_edge_rank_vec) : edge_wgt_vec(in_edge_wgt_vec), edge_rank_vec(in_edge_rank_vec) {};
+
+        bool operator()(const int & e1, const int & e2) const
+        {
+            if (edge_wgt_vec[e1]!=edge_wgt_vec[e2])
+            {
+                return (edge_wgt_vec[e1]>edge_wgt_vec[e2]);
+            }
+            return (edge_rank_vec[e1]<edge_rank_vec[e2]);
+        }
+
+    private:
+        const DoubleVec & edge_wgt_vec;
+        const vector<int> & edge_rank_vec;
+};
+
+
+/* thread argument */
+struct bsuitor_thread_arg
+{
+    BSuitorApproxBmatch * alg;
+    int phase;
+    vector<int> displaced_vec;
+};
+
+
+/* constructor */
+BSuitorApproxBmatch::
+BSuitorApproxBmatch() : num_thread(0), verbose(0), num_node(0), num_ijw(0)
+{
+    register int k;
+
+    description_str = string(BSUITORAPPROXBMATCH);
+    for (k=0; k<BSUITOR_NUM_LOCK; k++)
+    {
+        pthread_mutex_init(&node_lock_arr[k], NULL);
+    }
+    pthread_mutex_init(&queue_lock, NULL);
+}
+
+
+/* destructor */
+BSuitorApproxBmatch::
+~BSuitorApproxBmatch()
+{
+    register int k;
+
+    //cerr << "BSuitorApproxBmatch destructor> " << endl;
+    for (k=0; k<BSUITOR_NUM_LOCK; k++)
+    {
+        pthread_mutex_destroy(&node_lock_arr[k]);
+    }
+    pthread_mutex_destroy(&queue_lock);
+    num_node = 0;
+    num_ijw = 0;
+}
+
+
+/* memory estimate: per edge, the local copy of the ijw (24), the edge
+ * arrays (20), both adjacency entries and their links (16), the heap
+ * entries (8) and the b-matching (28) */
+double BSuitorApproxBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return 96.0*double(num_ijw) + 64.0*double(num_node);
+}
+/* end memory_estimate */
+
+
+/* number of threads used for num_thread */
+int BSuitorApproxBmatch::
+select_num_thread(const int & num_thread)
+{
+    long num_cpu;
+
+    if (num_thread>0)
+    {
+        return num_thread;
+    }
+    num_cpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_cpu<1)
+    {
+        return 1;
+    }
+    return int(num_cpu);
+}
+/* end select_num_thread */
+
+
+/* print memory */
+void BSuitorApproxBmatch::
+print(const int & print_what)
+{
+    register int u;
+    register int k;
+
+    if (verbose==0)
+    {
+        return;
+    }
+
+    /* adjacency */
+    if (print_what==0) {
+        solver_log() << "Amat>" << endl;
+        for (u=0; u<num_node; u++)
+        {
+            solver_log() << "  cap=" << bcap_vec[u];
+            solver_log() << "  i=" << u;
+            solver_log() << "  j:w=[";
+            for (k=row_begin_vec[u]; (k<row_begin_vec[u+1]) && (k<row_begin_vec[u]+50); k++)
+            {
+                solver_log() << " " << edge_u_vec[row_edge_vec[k]] + edge_v_vec[row_edge_vec[k]] - u;
+                solver_log() << ":" << edge_wgt_vec[row_edge_vec[k]] << " ";
+            }
+            if (k<row_begin_vec[u+1])   solver_log() << "... ";
+            solver_log() << "]" << endl;
+        }
+    }
+
+    /* suitors */
+    if (print_what==1) {
+        solver_log() << "Suitors>" << endl;
+        for (u=0; u<num_node; u++)
+        {
+            solver_log() << "  i=" << u << "  [";
+            for (k=0; k<heap_size_vec[u]; k++)
+            {
+                solver_log() << " " << edge_u_vec[heap_edge_vec[heap_begin_vec[u]+k]] + edge_v_vec[heap_edge_vec[heap_begin_vec[u]+k]] - u;
+            }
+            solver_log() << " ]" << endl;
+        }
+    }
+}
+/* end print */
+
+
+/* initialize assuming 0-based indices for nodes */
+void BSuitorApproxBmatch::
+init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & ijw_vec)
+{
+    register int u;
+    register int v;
+    register int e;
+    vector<int> row_end_vec;
+
+    verbose = in_verbose;
+    num_node = in_num_node;
+    num_ijw = in_num_ijw;
+
+    /* edges */
+    edge_u_vec.resize(num_ijw);
+    edge_v_vec.resize(num_ijw);
+    edge_wgt_vec.resize(num_ijw);
+    seeded_rank(num_ijw, seed, edge_rank_vec);
+
+    /* row sizes, without self-loops */
+    row_begin_vec.assign(num_node+1, 0);
+    for (e=0; e<num_ijw; e++)
+    {
+        u = int(ijw_vec[3*e + 0]);
+        v = int(ijw_vec[3*e + 1]);
+        edge_u_vec[e] = u;
+        edge_v_vec[e] = v;
+        edge_wgt_vec[e] = ijw_vec[3*e + 2];
+        if (u!=v)
+        {
+            row_begin_vec[u+1] += 1;
+            row_begin_vec[v+1] += 1;
+        }
+    }
+    for (u=0; u<num_node; u++)
+    {
+        row_begin_vec[u+1] += row_begin_vec[u];
+    }
+
+    /* fill rows, sorted by run_threads(0) */
+    row_edge_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (e=0; e<num_ijw; e++)
+    {
+        u = edge_u_vec[e];
+        v = edge_v_vec[e];
+        if (u!=v)
+        {
+            row_edge_vec[row_end_vec[u]++] = e;
+            row_edge_vec[row_end_vec[v]++] = e;
+        }
+    }
+    row_next_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+
+    /* capacities, at most the number of nbrs, and the heaps */
+    bcap_vec.assign(num_node, 0);
+    count_vec.assign(num_node, 0);
+    heap_begin_vec.assign(num_node, 0);
+    heap_size_vec.assign(num_node, 0);
+    for (u=0; u<num_node; u++)
+    {
+        /* N.B. index the SECOND COLUMN of deg_bdd_vec */
+        bcap_vec[u] = max(0, min(int(deg_bdd_vec[2*u+1]), row_begin_vec[u+1] - row_begin_vec[u]));
+        if (u+1<num_node)
+        {
+            heap_begin_vec[u+1] = heap_begin_vec[u] + bcap_vec[u];
+        }
+    }
+    heap_edge_vec.assign((num_node>0) ? heap_begin_vec[num_node-1] + bcap_vec[num_node-1] : 0, -1);
+
+    B_match.clear();
+}
+/* end init */
+
+
+/* thread entry point */
+void * BSuitorApproxBmatch::
+run_thread(void * arg)
+{
+    bsuitor_thread_arg * targ = (bsuitor_thread_arg *)arg;
+    targ->alg->work(targ->phase, targ->displaced_vec);
+    return NULL;
+}
+/* end run_thread */
+
+
+/* run work() on the nodes of queue_vec with num_thread threads, collecting
+ * the displaced nodes of all threads in displaced_vec */
+void BSuitorApproxBmatch::
+run_threads(const int & phase)
+{
+    register int t;
+    int L_num_thread;
+    vector<bsuitor_thread_arg> targ_vec;
+    vector<pthread_t> thread_vec;
+    vector<int> created_vec;
+
+    /* no more threads than chunks of work */
+    L_num_thread = select_num_thread(num_thread);
+    L_num_thread = max(1, min(L_num_thread, int((queue_vec.size() + BSUITOR_CHUNK - 1)/BSUITOR_CHUNK)));
+
+    queue_next = 0;
+    targ_vec.resize(L_num_thread);
+    thread_vec.resize(L_num_thread);
+    created_vec.assign(L_num_thread, 0);
+    for (t=0; t<L_num_thread; t++)
+    {
+        targ_vec[t].alg = this;
+        targ_vec[t].phase = phase;
+    }
+
+    /* the calling thread is thread 0; if a thread can not be created,
+     * the remaining threads take its share */
+    for (t=1; t<L_num_thread; t++)
+    {
+        created_vec[t] = (pthread_create(&thread_vec[t], NULL, &BSuitorApproxBmatch::run_thread, &targ_vec[t])==0);
+    }
+    work(phase, targ_vec[0].displaced_vec);
+    for (t=1; t<L_num_thread; t++)
+    {
+        if (created_vec[t])
+        {
+            pthread_join(thread_vec[t], NULL);
+        }
+    }
+
+    displaced_vec.clear();
+    for (t=0; t<L_num_thread; t++)
+    {
+        displaced_vec.insert(displaced_vec.end(), targ_vec[t].displaced_vec.begin(), targ_vec[t].displaced_vec.end());
+    }
+}
+/* end run_threads */
+
+
+/* process the nodes of queue_vec, a chunk at a time, until it is exhausted
+ *
+ * phase 0 sorts the rows, heaviest edge first, phase 1 makes the proposals
+ * */
+void BSuitorApproxBmatch::
+work(const int & phase, vector<int> & L_displaced_vec)
+{
+    register int k;
+    register int u;
+    int first;
+    int last;
+
+    while (1)
+    {
+        pthread_mutex_lock(&queue_lock);
+        first = queue_next;
+        queue_next = min(int(queue_vec.size()), queue_next + BSUITOR_CHUNK);
+        last = queue_next;
+        pthread_mutex_unlock(&queue_lock);
+        if (first==last)
+        {
+            break;
+        }
+
+        for (k=first; k<last; k++)
+        {
+            u = queue_vec[k];
+            if (phase==0)
+            {
+                sort(row_edge_vec.begin() + row_begin_vec[u], row_edge_vec.begin() + row_begin_vec[u+1], bsuitor_edge_before(edge_wgt_vec, edge_rank_vec));
+            }
+            else
+            {
+                propose(u, L_displaced_vec);
+            }
+        }
+    }
+}
+/* end work */
+
+
+/* u proposes along its edges, heaviest first, until its suitors hold
+ * bcap_vec[u] of its proposals or it has no nbrs left
+ *
+ * a proposal along e to v is accepted if v has a free slot, or if e comes
+ * before the lightest proposal held by v, which is then displaced; a node
+ * loses a proposal only to a heavier one, so u never proposes to the same
+ * nbr twice, and the nodes whose proposals were displaced are collected in
+ * L_displaced_vec to propose again in the next round
+ * */
+void BSuitorApproxBmatch::
+propose(const int & u, vector<int> & L_displaced_vec)
+{
+    int e;
+    int v;
+    int x;
+    int d;
+    int need;
+    int accepted;
+    int * heap_ptr;
+    bsuitor_edge_before edge_before(edge_wgt_vec, edge_rank_vec);
+
+    while (1)
+    {
+        pthread_mutex_lock(&node_lock_arr[u % BSUITOR_NUM_LOCK]);
+        need = (count_vec[u]<bcap_vec[u]);
+        pthread_mutex_unlock(&node_lock_arr[u % BSUITOR_NUM_LOCK]);
+        if ((!need) || (row_next_vec[u]==row_begin_vec[u+1]))
+        {
+            break;
+        }
+
+        /* next heaviest nbr */
+        e = row_edge_vec[row_next_vec[u]++];
+        v = edge_u_vec[e] + edge_v_vec[e] - u;
+        if (bcap_vec[v]==0)
+        {
+            continue;
+        }
+
+        /* propose to v */
+        accepted = 0;
+        d = -1;
+        pthread_mutex_lock(&node_lock_arr[v % BSUITOR_NUM_LOCK]);
+        heap_ptr = &heap_edge_vec[heap_begin_vec[v]];
+        if (heap_size_vec[v]<bcap_vec[v])
+        {
+            heap_ptr[heap_size_vec[v]++] = e;
+            push_heap(heap_ptr, heap_ptr + heap_size_vec[v], edge_before);
+            accepted = 1;
+        }
+        else if (edge_before(e, heap_ptr[0]))
+        {
+            pop_heap(heap_ptr, heap_ptr + heap_size_vec[v], edge_before);
+            d = heap_ptr[heap_size_vec[v]-1];
+            heap_ptr[heap_size_vec[v]-1] = e;
+            push_heap(heap_ptr, heap_ptr + heap_size_vec[v], edge_before);
+            accepted = 1;
+        }
+        pthread_mutex_unlock(&node_lock_arr[v % BSUITOR_NUM_LOCK]);
+
+        if (accepted)
+        {
+            pthread_mutex_lock(&node_lock_arr[u % BSUITOR_NUM_LOCK]);
+            count_vec[u] += 1;
+            pthread_mutex_unlock(&node_lock_arr[u % BSUITOR_NUM_LOCK]);
+        }
+
+        /* the proposer of the displaced edge proposes again */
+        if (d>=0)
+        {
+            x = edge_u_vec[d] + edge_v_vec[d] - v;
+            pthread_mutex_lock(&node_lock_arr[x % BSUITOR_NUM_LOCK]);
+            count_vec[x] -= 1;
+            pthread_mutex_unlock(&node_lock_arr[x % BSUITOR_NUM_LOCK]);
+            L_displaced_vec.push_back(x);
+        }
+    }
+}
+/* end propose */
+
+
+/* solve */
+int BSuitorApproxBmatch::
+solve()
+{
+    register int u;
+    register int k;
+    int num_round;
+    vector<char> match_vec;
+
+    /* sort the rows */
+    queue_vec.resize(num_node);
+    for (u=0; u<num_node; u++)
+    {
+        queue_vec[u] = u;
+    }
+    run_threads(0);
+    print(0);
+
+    /* every node with capacity proposes, then the displaced nodes,
+     * each once per round, until none is displaced */
+    queue_vec.clear();
+    for (u=0; u<num_node; u++)
+    {
+        if (bcap_vec[u]>0)
+        {
+            queue_vec.push_back(u);
+        }
+    }
+    num_round = 0;
+    while (queue_vec.size()>0)
+    {
+        run_threads(1);
+        num_round += 1;
+        sort(displaced_vec.begin(), displaced_vec.end());
+        displaced_vec.erase(unique(displaced_vec.begin(), displaced_vec.end()), displaced_vec.end());
+        queue_vec.swap(displaced_vec);
+    }
+    print(1);
+    profile.count("bsuitor_rounds", num_round);
+    if (verbose>0)
+    {
+        solver_log() << " BSuitorApproxBmatch> threads=" << select_num_thread(num_thread);
+        solver_log() << " rounds=" << num_round << endl;
+    }
+
+    /* the suitors of a node are also its partners; collect the edges held
+     * in the heaps, in edge order */
+    match_vec.assign(num_ijw, 0);
+    for (k=0; k<int(heap_edge_vec.size()); k++)
+    {
+        if (heap_edge_vec[k]>=0)
+        {
+            match_vec[heap_edge_vec[k]] = 1;
+        }
+    }
+    B_match.clear();
+    for (k=0; k<num_ijw; k++)
+    {
+        if (match_vec[k])
+        {
+            B_match.push_back(k);
+        }
+    }
+    return B_match.size();
+}
+/* end solve */
+
+
+/* copy b-matching approx solution using 0-based indices for nodes */
+void BSuitorApproxBmatch::
+solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec)
+{
+    register int k;
+
+    bmatch_edge_vec.clear();
+    bmatch_edge_vec.reserve(3*num_bmatch_edge);
+    for (k=0; k<int(B_match.size()); k++)
+    {
+        bmatch_edge_vec.push_back(edge_u_vec[B_match[k]]);
+        bmatch_edge_vec.push_back(edge_v_vec[B_match[k]]);
+        bmatch_edge_vec.push_back(1.0);
+    }
+}
+/* end solution */
+
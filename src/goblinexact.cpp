@@ -6,13 +6,51 @@
 #include <iostream>
 #include <cmath>
 #include <climits>
+#include <algorithm>
+#include <pthread.h>
 using namespace std;
 #include "goblinexact.hpp"
 
 
+/* goblin keeps a static table of controllers, so controllers are 
+ * created and destroyed under this lock */
+static pthread_mutex_t goblin_context_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* goblin keeps global state beyond its controllers (e.g. the default
+ * context, static counters), so the graph of a solve is built, solved and
+ * deleted under this lock, and the goblin methods run one at a time in
+ * the process, whatever the front end */
+static pthread_mutex_t goblin_solve_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* the goblin log handler gets no controller, so each thread keeps the
+ * controller of the solve it is running, and the handler logs through
+ * that one instead of the shared goblinDefaultContext */
+static pthread_key_t goblin_log_key;
+static pthread_once_t goblin_log_once = PTHREAD_ONCE_INIT;
+
+static void goblin_log_key_create()
+{
+    pthread_key_create(&goblin_log_key, NULL);
+}
+
+static void set_log_context(goblinController * context)
+{
+    pthread_once(&goblin_log_once, goblin_log_key_create);
+    pthread_setspecific(goblin_log_key, context);
+}
+
 void myLogEventHandler(msgType msg,TModule mod,THandle OH,char *logText)
 {
-    goblinDefaultContext.PlainLogEventHandler(msg,mod,OH,logText);
+    goblinController * context;
+
+    pthread_once(&goblin_log_once, goblin_log_key_create);
+    context = (goblinController *)pthread_getspecific(goblin_log_key);
+    if (context)
+    {
+        context->PlainLogEventHandler(msg,mod,OH,logText);
+    }
 }
 
 GoblinExactBmatch::
@@ -21,18 +59,46 @@ GoblinExactBmatch::
     // cerr << "GoblinExactBmatch destructor> " << endl;
     num_node = 0;
     num_ijw = 0;
+    pthread_mutex_lock(&goblin_solve_mutex);
+    release();
+    pthread_mutex_unlock(&goblin_solve_mutex);
+}
+
+
+/* memory estimate: per edge, four copies of the ijw (96) and about 320
+ * bytes of goblin arcs, counting the balanced flow network of
+ * MinCMatching; per node about 512 bytes of goblin nodes */
+double GoblinExactBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return 416.0*double(num_ijw) + 512.0*double(num_node);
+}
+/* end memory_estimate */
+
+
+/* release gptr and context */
+void GoblinExactBmatch::
+release()
+{
+    pthread_mutex_lock(&goblin_context_mutex);
     if (gptr)
     {
         delete gptr;
+        gptr = NULL;
+    }
+    if (context)
+    {
+        pthread_once(&goblin_log_once, goblin_log_key_create);
+        if (pthread_getspecific(goblin_log_key)==context)
+        {
+            set_log_context(NULL);
+        }
+        delete context;
+        context = NULL;
     }
-    /*
-    if (LB_TCap_vec)
-        delete[] LB_TCap_vec; 
-    if (UB_TCap_vec)
-        delete[] UB_TCap_vec;
-    */
-    /* seg. fault, b/c gra2bal object does this */
+    pthread_mutex_unlock(&goblin_context_mutex);
 }
+/* end of release */
 
 
 /* print memory */
@@ -46,32 +112,32 @@ print(const int & print_what)
     /* nodes */
     if (print_what==1) 
     {
-        cerr << " Nodes:" << endl;
+        solver_log() << " Nodes:" << endl;
         TNode v;
         for (v=0; v<gptr->N(); v++ ) 
         {
-            cerr << " node=" << v;
-            cerr << " deg=" << gptr->Deg(v);
-            cerr << " indeg=" << gptr->DegIn(v);
-            cerr << " outdeg=" << gptr->DegOut(v);
-            cerr << " demand=" << gptr->Demand(v);
-            cerr << endl;
+            solver_log() << " node=" << v;
+            solver_log() << " deg=" << gptr->Deg(v);
+            solver_log() << " indeg=" << gptr->DegIn(v);
+            solver_log() << " outdeg=" << gptr->DegOut(v);
+            solver_log() << " demand=" << gptr->Demand(v);
+            solver_log() << endl;
         }
     }
     /* arcs */
     if (print_what==2) 
     {
-        cerr << " Edges:" << endl;
+        solver_log() << " Edges:" << endl;
         TArc a;
         for (a=0; a<gptr->M(); a++ ) 
         {
-            cerr << " edge=" << 2*a;
-            cerr << " u=" << gptr->StartNode(2*a);
-            cerr << " v=" << gptr->EndNode(2*a);
-            cerr << " lcap=" << gptr->LCap(2*a);
-            cerr << " ucap=" << gptr->UCap(2*a);
-            cerr << " length=" << gptr->Length(2*a);
-            cerr << endl;
+            solver_log() << " edge=" << 2*a;
+            solver_log() << " u=" << gptr->StartNode(2*a);
+            solver_log() << " v=" << gptr->EndNode(2*a);
+            solver_log() << " lcap=" << gptr->LCap(2*a);
+            solver_log() << " ucap=" << gptr->UCap(2*a);
+            solver_log() << " length=" << gptr->Length(2*a);
+            solver_log() << endl;
         }
     }
     /* cout << nodeI << " " << nodeJ << " " << int(cost) << endl; */
@@ -88,13 +154,22 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
     num_node = in_num_node;
 
     /* create goblin arrays of lower/upper capacities for b-matching */
-    LB_TCap_vec = new TCap[num_node]; // +1
-    UB_TCap_vec = new TCap[num_node]; // +1
+    LB_TCap_vec.assign(num_node, 0);
+    UB_TCap_vec.assign(num_node, 0);
+
+    /* drop the graph of a previous solve, and create a controller that
+     * inherits the configuration of the default context */
+    release();
+    pthread_mutex_lock(&goblin_context_mutex);
+    context = new goblinController(goblinDefaultContext);
 
     if (1) 
     {
-        /* initialize N node sparse graph */
-        gptr = new graph((TNode)num_node);
+        /* initialize N node sparse graph, with the arc arrays sized up 
+         * front so that inserting the arcs does not reallocate them */
+        graph* sgptr = new graph((TNode)num_node, *context);
+        static_cast<sparseRepresentation*>(sgptr->Representation())->SetCapacity((TNode)num_node, (TArc)in_num_ijw);
+        gptr = sgptr;
     }
     else
     {
@@ -104,9 +179,10 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
          * dense graph data structures, however, the behaviours of 
          * edge capacities and lengths are not exactly the same.
          * */
-        gptr = new denseGraph((TNode)num_node);
+        gptr = new denseGraph((TNode)num_node, 0, *context);
     }
     /* gptr = new graph((TNode)0, (TOption)0); */
+    pthread_mutex_unlock(&goblin_context_mutex);
 
 
     /* */
@@ -115,7 +191,8 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
 
 
     /* */
-    goblinController &CT = goblinDefaultContext;
+    goblinController &CT = *context;
+    set_log_context(context);
     CT.traceLevel = min(verbose,1); 
     /* larger traceLevel uses Tcl/Tk ... equivalently, one can
      * disable Tcl/Tk by UN-defining _TRACING_ in goblin/include/config.h
@@ -125,6 +202,7 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
     if (CT.traceLevel>0) 
     {
         //CT.logStream       = new ofstream("/dev/null");
+        CT.logStream       = &solver_log();
         CT.logEventHandler = &myLogEventHandler;
         CT.Trace(gptr->Handle(),CT.traceLevel);
     }
@@ -144,16 +222,18 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
     /* */
     TNode u;
     TNode v;
-    float cost;
-    /* connect goblin nodes */
+    int cost;
+    /* connect goblin nodes (a float cost would round costs above 2^24) */
     for (i=0; i<num_ijw; i++) 
     {
         u = TNode(int(ijw_vec[3*i+0]));
         v = TNode(int(ijw_vec[3*i+1]));
-        cost = float(floor(ijw_vec[3*i+2]));
-        gptr->InsertArc(u, v, 1, int(cost));
+        cost = int(floor(ijw_vec[3*i+2]));
+        gptr->InsertArc(u, v, 1, cost);
         /* InsertArc(node, node, capacity, cost) */
     }
+    profile.count("goblin_nodes", double(gptr->N()));
+    profile.count("goblin_arcs", double(gptr->M()));
 
     /* print */
     print(1); /* nodes */
@@ -161,15 +241,97 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
 }
 /* end of init */
 
+/* priority queue selected for a graph, resolving GOBLIN_PQ_AUTO
+ *
+ * the linear-scan basic heap below GOBLIN_PQ_BASIC_MAX_NODE nodes,
+ * otherwise the binary heap, whose array layout is more cache-friendly
+ * than the pointer-based fibonacci heap; the cutoff is an unmeasured
+ * default, bmatch -queue -2 compares the heaps on a given graph
+ * */
+int GoblinExactBmatch::
+select_pq(const int & meth_pq, const int & num_node)
+{
+    if (meth_pq>=0)
+    {
+        return meth_pq;
+    }
+    if (num_node<GOBLIN_PQ_BASIC_MAX_NODE)
+    {
+        return GOBLIN_PQ_BASIC;
+    }
+    return GOBLIN_PQ_BINARY;
+}
+/* end select_pq */
+
+
 /* solve */
 int GoblinExactBmatch::
 solve()
 {
     int num_bmatch_edge;
+    bool perfect;
+
+    TCap* LB_TCap_ptr;
+    TCap* UB_TCap_ptr;
+
+    /* configure the controller methods used inside MinCMatching */
+    goblinController &CT = *context;
+    set_log_context(context);
+    if (CT.traceLevel>0)
+    {
+        CT.logStream = &solver_log();
+    }
+    CT.methPQ = select_pq(meth_pq, num_node);
+    if (meth_primal_dual>=0)
+    {
+        CT.methPrimalDual = meth_primal_dual;
+    }
+    if (verbose>0)
+    {
+        solver_log() << " GoblinExactBmatch> methPQ=" << CT.methPQ;
+        solver_log() << " methPrimalDual=" << CT.methPrimalDual << endl;
+    }
+
+#if defined(_TIMERS_)
+    register int i;
+
+    /* reset and enable the goblin timers for this solve */
+    if (profile.goblin_timers)
+    {
+        CT.ResetTimers();
+        for (i=0; i<NoTimer; i++)
+        {
+            CT.globalTimer[i]->Enable();
+        }
+    }
+#endif
+
+    /* the gra2bal object built by MinCMatching takes ownership of the 
+     * capacity arrays and frees them, so it gets its own copies */
+    LB_TCap_ptr = new TCap[num_node];
+    UB_TCap_ptr = new TCap[num_node];
+    copy(LB_TCap_vec.begin(), LB_TCap_vec.end(), LB_TCap_ptr);
+    copy(UB_TCap_vec.begin(), UB_TCap_vec.end(), UB_TCap_ptr);
 
     /* Solve problem */
-    //if (!gptr->MinCMatching(LB_TCap_vec)) 
-    if (!gptr->MinCMatching(LB_TCap_vec, UB_TCap_vec)) 
+    //perfect = gptr->MinCMatching(LB_TCap_ptr);
+    perfect = gptr->MinCMatching(LB_TCap_ptr, UB_TCap_ptr);
+
+#if defined(_TIMERS_)
+    /* collect the goblin timers that were used */
+    if (profile.goblin_timers)
+    {
+        for (i=0; i<NoTimer; i++)
+        {
+            if (CT.globalTimer[i]->AccTime()>0)
+            {
+                profile.goblin_timer(listOfTimers[i].timerName, CT.globalTimer[i]->AccTime());
+            }
+        }
+    }
+#endif
+
+    if (!perfect) 
     {
         return -1;
     }
@@ -235,6 +397,27 @@ scale_weight3(const int & num_ijw, DoubleVec & ijw_vec, const double & max1)
 /* end scale_weight3 */
 
 
+/* true if all weights are integers whose absolute sum is at most max1 */
+bool GoblinExactBmatch::
+is_integral_weight(const int & num_ijw, const DoubleVec & ijw_vec, const double & max1)
+{
+    register int k;
+    register double  sum0;
+
+    sum0 = 0.0;
+    for (k=0; k<num_ijw; k++) 
+    {
+        if (ijw_vec[3*k+2]!=floor(ijw_vec[3*k+2]))
+        {
+            return false;
+        }
+        sum0 = sum0 + fabs(ijw_vec[3*k+2]);
+    }
+    return (sum0<=max1);
+}
+/* end is_integral_weight */
+
+
 /* scale_weight2 */
 void GoblinExactBmatch::
 scale_weight2(const int & num_ijw, DoubleVec & ijw_vec, const double & ff)
@@ -279,7 +462,7 @@ scale_weight(const int & num_ijw, DoubleVec & ijw_vec, const double & min1, cons
 
 
 
-/* solve_bmatching_problem 
+/* solve_bmatching_view 
  *
  *  MIN COST formulation
  *
@@ -290,7 +473,7 @@ scale_weight(const int & num_ijw, DoubleVec & ijw_vec, const double & min1, cons
  *   (i.e. if LB>UB, then UB is set to LB, which is different from maxwgt)
  * */
 int GoblinExactBmatch::
-solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
 {
     register int i;
     register int j;
@@ -299,35 +482,29 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
 
     /* local (non-const) copies */
     int L_num_node = in_num_node;
-    int L_num_ijw = in_num_ijw;
-    DoubleVec L_ijw_vec = in_ijw_vec;
+    int L_num_ijw = 0;
+    DoubleVec L_ijw_vec;
     DoubleVec L_deg_bdd_vec = in_deg_bdd_vec;
     DoubleVec L_in_deg_bdd_vec = in_deg_bdd_vec;
 
     /* degrees */
     DoubleVec deg_vec(L_num_node, 0);     /* of input graph */
 
-    /* adjacency and weights */
-    SparseVecVec AAmat;
-    SparseVecVec WWmat;
-    SparseVecIterator sp;
+    /* nodes kept */
+    vector<bool> keep_vec(L_num_node, true);
+
+    /* weights */
+    int W_num_ijw = 0;
+    DoubleVec W_ijw_vec;
 
-    /* remove edges that are incident to nodes with upper bound at zero */
-    ijw_2_svecvec_symm(L_num_ijw, L_ijw_vec, L_num_node, AAmat);
+    /* remove edges that are incident to nodes with upper bound at zero, 
+     * and extract the upper triangle ijw */
+    profile.start("preprocess");
     for (i=0; i<L_num_node; i++)
     {
-        if (in_deg_bdd_vec[2*i + 1]<=0)
-        {
-            AAmat[i]->clear();
-            for (j=0; j<L_num_node; j++) 
-            {
-                AAmat[j]->erase(i);
-            }
-        }
+        keep_vec[i] = (in_deg_bdd_vec[2*i + 1]>0);
     }
-    /* extract updated upper triangle ijw */
-    svecvec_2_ijw(L_num_node, AAmat, L_num_ijw, L_ijw_vec);
-    ijw_upper_tri(L_num_ijw, L_ijw_vec, 0);
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, L_num_ijw, L_ijw_vec);
     
     /* compute degree (self-loops=2)*/
     for (k=0; k<L_num_ijw; k++) {
@@ -367,16 +544,27 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
      * DEPRECATED: scale_weight(L_num_ijw, L_ijw_vec, 1.0, GOBLIN_COST_SCALE);
      * OLD: scale_weight2(L_num_ijw, L_ijw_vec, GOBLIN_COST_SCALE);
 	 * OLD: scale_weight3(L_num_ijw, L_ijw_vec, 1073741823);
+     *
+     * integral weights whose sum already fits are passed unscaled, so that
+     * goblin optimizes the exact costs
      * */
-	scale_weight3(L_num_ijw, L_ijw_vec, INT_MAX);
+    if (!is_integral_weight(L_num_ijw, L_ijw_vec, INT_MAX))
+    {
+        scale_weight3(L_num_ijw, L_ijw_vec, INT_MAX);
+    }
+    profile.stop("preprocess");
 
 
-    /* */
-    success = BmatchSolver::solve_bmatching_problem(L_num_node, L_deg_bdd_vec, L_num_ijw, L_ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+    /* init, solve and solution, one goblin solve at a time */
+    pthread_mutex_lock(&goblin_solve_mutex);
+    success = BmatchSolver::solve_bmatching_view(L_num_node, L_deg_bdd_vec, L_num_ijw, IjwView(L_ijw_vec), num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
+    pthread_mutex_unlock(&goblin_solve_mutex);
 
 
-    /* create WWmat */
-    ijw_2_svecvec_symm(in_num_ijw, in_ijw_vec, in_num_node, WWmat);
+    /* sorted upper triangle weights */
+    profile.start("weight");
+    keep_vec.assign(in_num_node, true);
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, W_num_ijw, W_ijw_vec);
 
     /* compute weight */
     bmatch_wgt = 0.0;
@@ -384,16 +572,13 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     {
         i = int(bmatch_edge_vec[3*k+0]);
         j = int(bmatch_edge_vec[3*k+1]);
-        bmatch_wgt += (*WWmat[i])[j];
+        bmatch_wgt += ijw_sorted_weight(W_num_ijw, W_ijw_vec, i, j);
     }
-
-    /* local cleanup */
-    delete_svecvec(AAmat);
-    delete_svecvec(WWmat);
+    profile.stop("weight");
 
     return success;
 }
-/* end solve_bmatching_problem */
+/* end solve_bmatching_view */
 
 
 
@@ -409,7 +594,17 @@ ComplementaryGoblinExactBmatch::
 }
 
 
-/* solve_bmatching_problem
+/* memory estimate: the mincost method, one more copy of the ijw and the
+ * complementary b-matching (48) */
+double ComplementaryGoblinExactBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return GoblinExactBmatch::memory_estimate(num_node, num_ijw) + 48.0*double(num_ijw);
+}
+/* end memory_estimate */
+
+
+/* solve_bmatching_view
  *
  *  MAX WGT formulation
  *
@@ -420,7 +615,7 @@ ComplementaryGoblinExactBmatch::
  *   (i.e. if LB>UB, then LB is set to UB, which is different from mincost)
  * */
 int ComplementaryGoblinExactBmatch::
-solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
 {
     register int i;
     register int j;
@@ -429,8 +624,8 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     int success;
 
     int     L_num_node = in_num_node;
-    int     L_num_ijw = in_num_ijw;
-    DoubleVec L_ijw_vec = in_ijw_vec;
+    int     L_num_ijw = 0;
+    DoubleVec L_ijw_vec;
     DoubleVec L_deg_bdd_vec = in_deg_bdd_vec;
     /* NEW */
     DoubleVec L_in_deg_bdd_vec = in_deg_bdd_vec;
@@ -439,31 +634,29 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     /* degrees */
     DoubleVec deg_vec(L_num_node, 0);     /* of input graph */
 
-    /* adjacency and weights */
-    SparseVecVec AAmat;
-    SparseVecVec BBmat;
-    SparseVecVec WWmat;
-    SparseVecIterator sp;
+    /* nodes kept */
+    vector<bool> keep_vec(L_num_node, true);
+
+    /* pruning */
+    int num_prune;
+    vector<int> ub_vec;
 
-    /* remove edges that are incident to nodes with upper bound at zero */
-    ijw_2_svecvec_symm(L_num_ijw, L_ijw_vec, L_num_node, AAmat);
+    /* matching of the complementary problem */
+    int B_num_ijw;
+    DoubleVec B_ijw_vec;
+
+    /* weights */
+    int W_num_ijw = 0;
+    DoubleVec W_ijw_vec;
+
+    /* remove edges that are incident to nodes with upper bound at zero, 
+     * and extract the upper triangle ijw in (i,j) order */
+    profile.start("preprocess");
     for (i=0; i<L_num_node; i++)
     {
-        if (L_in_deg_bdd_vec[2*i + 1]<=0)
-        {
-            AAmat[i]->clear();
-            for (j=0; j<L_num_node; j++) 
-            {
-                AAmat[j]->erase(i);
-            }
-        }
+        keep_vec[i] = (L_in_deg_bdd_vec[2*i + 1]>0);
     }
-    /* extract updated upper triangle ijw */
-    svecvec_2_ijw(L_num_node, AAmat, L_num_ijw, L_ijw_vec);
-    ijw_upper_tri(L_num_ijw, L_ijw_vec, 0);
-    
-    /* make AAmat logical */
-    logical_svecvec(AAmat);
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, L_num_ijw, L_ijw_vec);
 
     /* compute degree (self-loops=2)*/
     for (k=0; k<L_num_ijw; k++) {
@@ -472,6 +665,45 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
         deg_vec[i] += 1;
         deg_vec[j] += 1;
     }
+
+    /* drop the edges of no maxwgt b-matching, the lower bounds permitting */
+    if (prune)
+    {
+        for (i=0; i<L_num_node; i++)
+        {
+            if (keep_vec[i] && (L_in_deg_bdd_vec[2*i + 0]>0))
+            {
+                break;
+            }
+        }
+        if (i<L_num_node)
+        {
+            if (verbose>0)
+            {
+                solver_log() << " ComplementaryGoblinExactBmatch> lower bounds, no pruning" << endl;
+            }
+        }
+        else
+        {
+            ub_vec.resize(L_num_node);
+            for (i=0; i<L_num_node; i++)
+            {
+                ub_vec[i] = int(max(0.0, min(L_in_deg_bdd_vec[2*i + 1], deg_vec[i])));
+            }
+            num_prune = prune_dominated_edges(L_num_node, ub_vec, L_num_ijw, L_ijw_vec);
+            profile.count("pruned_edges", num_prune);
+            if (verbose>0)
+            {
+                solver_log() << " ComplementaryGoblinExactBmatch> pruned " << num_prune << " of " << L_num_ijw + num_prune << " edges" << endl;
+            }
+            deg_vec.assign(L_num_node, 0);
+            for (k=0; k<L_num_ijw; k++) {
+                deg_vec[int(L_ijw_vec[3*k+0])] += 1;
+                deg_vec[int(L_ijw_vec[3*k+1])] += 1;
+            }
+        }
+    }
+
     /* ensure validity of bounds */
     for (i=0; i<L_num_node; i++) 
     {
@@ -488,182 +720,159 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
     /* debug */
     if (verbose>2)
     {
-        cerr << "ijw_vec:" << endl;
-        write_mn_matrix(cerr, L_num_ijw, 3, L_ijw_vec, 4);
-        cerr << "deg_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 1, deg_vec, 4);
-        cerr << "maxwgt_deg_bdd_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 2, L_in_deg_bdd_vec, 4);
-        cerr << "mincost_deg_bdd_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 2, L_deg_bdd_vec, 4);
+        solver_log() << "ijw_vec:" << endl;
+        write_mn_matrix(solver_log(), L_num_ijw, 3, L_ijw_vec, 4);
+        solver_log() << "deg_vec:" << endl;
+        write_mn_matrix(solver_log(), L_num_node, 1, deg_vec, 4);
+        solver_log() << "maxwgt_deg_bdd_vec:" << endl;
+        write_mn_matrix(solver_log(), L_num_node, 2, L_in_deg_bdd_vec, 4);
+        solver_log() << "mincost_deg_bdd_vec:" << endl;
+        write_mn_matrix(solver_log(), L_num_node, 2, L_deg_bdd_vec, 4);
     }
+    profile.stop("preprocess");
 
 
     /* */
-    success = GoblinExactBmatch::solve_bmatching_problem(L_num_node, L_deg_bdd_vec, L_num_ijw, L_ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
-
+    success = GoblinExactBmatch::solve_bmatching_view(L_num_node, L_deg_bdd_vec, L_num_ijw, IjwView(L_ijw_vec), num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
 
-    /* matching: sparse symmetric adjacency */
-    ijw_2_svecvec_symm(num_bmatch_edge, bmatch_edge_vec, L_num_node,BBmat);
-    logical_svecvec(BBmat);
 
     /* take complement of solution matching A - B */
-    for (i=0; i<L_num_node; i++) 
-    {
-        for (sp=BBmat[i]->begin(); sp!=BBmat[i]->end(); sp++) 
-        {
-            j = sp->first;
-            AAmat[i]->erase(j);
-        }
-    }
-    /* extract updated ijw */
-    svecvec_2_ijw(L_num_node,AAmat,num_bmatch_edge,bmatch_edge_vec);
-    ijw_upper_tri(num_bmatch_edge,bmatch_edge_vec,0);
+    profile.start("solution");
+    B_num_ijw = num_bmatch_edge;
+    B_ijw_vec.swap(bmatch_edge_vec);
+    ijw_logical_difference(L_num_ijw, L_ijw_vec, B_num_ijw, B_ijw_vec, num_bmatch_edge, bmatch_edge_vec);
+    profile.stop("solution");
 
-    /* create WWmat */
-    ijw_2_svecvec_symm(in_num_ijw, in_ijw_vec, in_num_node, WWmat);
+    /* sorted upper triangle weights */
+    profile.start("weight");
+    keep_vec.assign(in_num_node, true);
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, W_num_ijw, W_ijw_vec);
 
-    /* compute weight and degree (self-loops=2) */
+    /* compute weight */
     bmatch_wgt = 0.0;
     for (k=0; k<num_bmatch_edge; k++) 
     {
         i = int(bmatch_edge_vec[3*k+0]);
         j = int(bmatch_edge_vec[3*k+1]);
-        bmatch_wgt += (*WWmat[i])[j];
+        bmatch_wgt += ijw_sorted_weight(W_num_ijw, W_ijw_vec, i, j);
     }
-
-
-    /* local cleanup */
-    delete_svecvec(AAmat);
-    delete_svecvec(BBmat);
-    delete_svecvec(WWmat);
+    profile.stop("weight");
 
 
     return success;
 }
-/* end solve_bmatching_problem */
-
-
-
-
-
-
-
-/* destructor */
-NegatedWeightsGoblinExactBmatch::
-~NegatedWeightsGoblinExactBmatch()
-{
-    //cerr << "NegatedWeightsGoblinExactBmatch destructor> " << endl;
-}
+/* end solve_bmatching_view */
 
 
-
-/* solve_bmatching_problem */
-int NegatedWeightsGoblinExactBmatch::
-solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+/* drop the edges of no maxwgt b-matching, see goblinexact.hpp */
+int ComplementaryGoblinExactBmatch::
+prune_dominated_edges(const int & num_node, const vector<int> & ub_vec, int & num_ijw, DoubleVec & ijw_vec)
 {
     register int i;
     register int j;
     register int k;
-
-    int success;
-
-    int L_num_node = in_num_node;
-    int L_num_ijw = in_num_ijw;
-    DoubleVec L_ijw_vec = in_ijw_vec;
-    DoubleVec L_deg_bdd_vec = in_deg_bdd_vec;
-
-    /* degrees */
-    DoubleVec deg_vec(L_num_node, 0);     /* of input graph */
-    DoubleVec bval_vec(L_num_node, 0);    /* upper bounds */
-
-    /* adjacency and weights */
-    SparseVecVec AAmat;
-    SparseVecVec WWmat;
-
-    /* working copy of upper degree bounds */
-    for (i=0; i<L_num_node; i++) 
-    {
-        bval_vec[i] = L_deg_bdd_vec[2*i + 1];
-    }
-    /* remove edges that are incident to nodes with upper bound at zero */
-    ijw_2_svecvec_symm(L_num_ijw, L_ijw_vec, L_num_node, AAmat);
-
-    for (i=0; i<L_num_node; i++)
-    {
-        if (bval_vec[i]==0)
+    int num_keep;
+    vector<int> deg_vec(num_node, 0);
+    vector<int> top_edge_vec(num_node, -1);
+    DoubleVec top1_vec(num_node, 0.0);
+    DoubleVec top2_vec(num_node, 0.0);
+    vector<int> row_begin_vec(num_node+1, 0);
+    vector<int> row_end_vec;
+    DoubleVec row_gain_vec;
+    DoubleVec thresh_vec(num_node, -1.0);
+    DoubleVec::iterator first;
+    DoubleVec L_ijw_vec;
+
+    /* degrees (self-loops=2), and the two heaviest weights of each node */
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        deg_vec[i] += 1;
+        deg_vec[j] += 1;
+        if (i!=j)
         {
-            AAmat[i]->clear();
-            for (j=0; j<L_num_node; j++) 
+            row_begin_vec[i+1] += 1;
+            row_begin_vec[j+1] += 1;
+        }
+        for (; ; i=j)
+        {
+            if ((top_edge_vec[i]<0) || (ijw_vec[3*k+2]>top1_vec[i]))
             {
-                AAmat[j]->erase(i);
+                top2_vec[i] = top1_vec[i];
+                top1_vec[i] = ijw_vec[3*k+2];
+                top_edge_vec[i] = k;
+            }
+            else if (ijw_vec[3*k+2]>top2_vec[i])
+            {
+                top2_vec[i] = ijw_vec[3*k+2];
+            }
+            if (i==j)
+            {
+                break;
             }
         }
     }
-    /* extract updated upper triangle ijw */
-    svecvec_2_ijw(L_num_node, AAmat, L_num_ijw, L_ijw_vec);
-    ijw_upper_tri(L_num_ijw,L_ijw_vec,0);
-    
-    /* compute degree (self-loops=2)*/
-    for (k=0; k<L_num_ijw; k++) {
-        i = int(L_ijw_vec[3*k+0]);
-        j = int(L_ijw_vec[3*k+1]);
-        deg_vec[i] += 1;
-        deg_vec[j] += 1;
-    }
-    /* ensure validity of bounds */
-    for (i=0; i<L_num_node; i++) 
+
+    /* gains w(u,x) - m_x((u,x)) of the nbrs x of each node u */
+    for (i=0; i<num_node; i++)
     {
-        bval_vec[i] = max(0.0, min(bval_vec[i], deg_vec[i]));
+        row_begin_vec[i+1] += row_begin_vec[i];
     }
-    /* setup lower bound using previous upper bounds */
-    for (i=0; i<L_num_node; i++)
+    row_gain_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (k=0; k<num_ijw; k++)
     {
-        L_deg_bdd_vec[2*i + 0] = bval_vec[i];
-        L_deg_bdd_vec[2*i + 1] = deg_vec[i];
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        if (i==j)
+        {
+            continue;
+        }
+        /* a nbr that can take no edge (ub 0, e.g. a bound in (0,1)) 
+         * dominates nothing */
+        if (ub_vec[j]>0)
+        {
+            row_gain_vec[row_end_vec[i]++] = ijw_vec[3*k+2] - ((ub_vec[j]>=deg_vec[j]) ? 0.0 : ((top_edge_vec[j]==k) ? top2_vec[j] : top1_vec[j]));
+        }
+        if (ub_vec[i]>0)
+        {
+            row_gain_vec[row_end_vec[j]++] = ijw_vec[3*k+2] - ((ub_vec[i]>=deg_vec[i]) ? 0.0 : ((top_edge_vec[i]==k) ? top2_vec[i] : top1_vec[i]));
+        }
     }
-    /* negate weights */
-    scale_weight2(L_num_ijw, L_ijw_vec, -1.0);
-    /* shift positive again */
-    scale_weight(L_num_ijw, L_ijw_vec, 1e-32, 1.0);
-    /* let GoblinExactBmatch solver handle GOBLIN_COST_SCALE scaling */
 
-
-    /* debug */
-    if (verbose>2)
+    /* an edge of u lighter than the ub_u-th largest gain of u is dropped */
+    for (i=0; i<num_node; i++)
     {
-        cerr << "ijw_vec:" << endl;
-        write_mn_matrix(cerr, L_num_ijw, 3, L_ijw_vec, 4);
-        cerr << "deg_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 1, deg_vec, 4);
-        cerr << "bval_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 1, bval_vec, 4);
-        cerr << "deg_bdd_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 2, L_deg_bdd_vec, 4);
+        if ((ub_vec[i]<=0) || (row_end_vec[i] - row_begin_vec[i]<ub_vec[i]))
+        {
+            continue;
+        }
+        first = row_gain_vec.begin() + row_begin_vec[i];
+        nth_element(first, first + ub_vec[i] - 1, row_gain_vec.begin() + row_end_vec[i], greater<double>());
+        thresh_vec[i] = *(first + ub_vec[i] - 1);
     }
 
     /* */
-    success =  GoblinExactBmatch::solve_bmatching_problem(L_num_node, L_deg_bdd_vec, L_num_ijw, L_ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
-
-    /* create WWmat */
-    ijw_2_svecvec_symm(in_num_ijw, in_ijw_vec, in_num_node, WWmat);
-
-    /* compute weight and degree (self-loops=2) */
-    bmatch_wgt = 0.0;
-    for (k=0; k<num_bmatch_edge; k++) 
+    L_ijw_vec.reserve(ijw_vec.size());
+    for (k=0; k<num_ijw; k++)
     {
-        i = int(bmatch_edge_vec[3*k+0]);
-        j = int(bmatch_edge_vec[3*k+1]);
-        bmatch_wgt += (*WWmat[i])[j];
-    }
-
-    /* local cleanup */
-    delete_svecvec(AAmat);
-    delete_svecvec(WWmat);
-
-    return success;
+        i = int(ijw_vec[3*k+0]);
+        j = int(ijw_vec[3*k+1]);
+        if ((i!=j) && ((ijw_vec[3*k+2]<thresh_vec[i]) || (ijw_vec[3*k+2]<thresh_vec[j])))
+        {
+            continue;
+        }
+        L_ijw_vec.push_back(ijw_vec[3*k+0]);
+        L_ijw_vec.push_back(ijw_vec[3*k+1]);
+        L_ijw_vec.push_back(ijw_vec[3*k+2]);
+    }
+    num_keep = int(L_ijw_vec.size()/3);
+    ijw_vec.swap(L_ijw_vec);
+    swap(num_ijw, num_keep);
+    return (num_keep - num_ijw);
 }
-/* end solve_bmatching_problem */
+/* end prune_dominated_edges */
 
 
 
@@ -671,3 +880,9 @@ solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_ve
 
 
 
+/* destructor */
+NegatedWeightsGoblinExactBmatch::
+~NegatedWeightsGoblinExactBmatch()
+{
+    //cerr << "NegatedWeightsGoblinExactBmatch destructor> " << endl;
+}
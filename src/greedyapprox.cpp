@@ -11,31 +11,38 @@ GreedyApproxBmatch::
 {
     //cerr << "GreedyApproxBmatch destructor> " << endl;
 
-    delete_svecvec(Amat);
-    //cerr << " .. destructor> done Amat" << endl; cerr.flush();
-
-    delete_svecvec(Wmat);
-    //cerr << " .. destructor> done Wmat" << endl; cerr.flush();
+    row_begin_vec.clear();
+    row_end_vec.clear();
+    row_nbr_vec.clear();
+    row_edge_vec.clear();
+
+    edge_u_vec.clear();
+    edge_v_vec.clear();
+    edge_wgt_vec.clear();
+    edge_alive_vec.clear();
+    edge_live_vec.clear();
+    nbr_cnt_vec.clear();
 
     bcap_vec.clear();
-    //cerr << " .. destructor> done bcap_vec" << endl;cerr.flush();
-
     deg_vec.clear();
-    //cerr << " .. destructor> done deg_vec" << endl; cerr.flush();
-
-    //cerr << " .. destructor> B_match "<< B_match.size() << endl; cerr.flush();
     B_match.clear();
-    //cerr << " .. destructor> done B_match" << endl; cerr.flush();
-
-    //cerr << " .. destructor> M_walk "<< M_walk.size() << endl; cerr.flush();
     M_walk.clear();
-    //cerr << " .. destructor> done M_walk" << endl; cerr.flush();
 
     num_node = 0;
     num_ijw = 0;
 }
 
 
+/* memory estimate: per edge, the local copy of the ijw (24), the edge
+ * arrays (26), both adjacency entries (16) and the b-matching (24) */
+double GreedyApproxBmatch::
+memory_estimate(const int & num_node, const int & num_ijw) const
+{
+    return 90.0*double(num_ijw) + 96.0*double(num_node);
+}
+/* end memory_estimate */
+
+
 
 /* print memory */
 void GreedyApproxBmatch::
@@ -43,8 +50,8 @@ print(const int & print_what)
 {
     register int i;
     register int j;
-    SparseVecConstIterator  svec;
-    EdgeList::iterator np;
+    register int s;
+    EdgeIndexList::iterator np;
 
     /* */
     if (verbose==0) 
@@ -52,93 +59,270 @@ print(const int & print_what)
         return;
     }
 
-    if (print_what==0) {
-        cerr << "Amat>" << endl;
-        for (i=0; i<num_node; i++)
-        {
-            cerr << "  num_edge=" << Amat[i]->size();
-            cerr << "  deg=" << deg_vec[i];
-            cerr << "  cap=" << bcap_vec[i];
-            /* */
-            cerr << "  i=" << i ;
-            cerr << "  j:w=[";
-            j = 0;
-            for(svec=Amat[i]->begin(); svec!=Amat[i]->end(); svec++) {
-                if (++j > 50) break;
-                cerr << " " << svec->first << ":" << svec->second << " "; 
-            }
-            if (svec!=Amat[i]->end())   cerr << "... ";
-            cerr << "]" << endl;
+    if ((print_what==0) || (print_what==1)) {
+        if (print_what==0) {
+            solver_log() << "Amat>" << endl;
+        } else {
+            solver_log() << "Wmat>" << endl;
         }
-    }
-
-    if (print_what==1) {
-        cerr << "Wmat>" << endl;
         for (i=0; i<num_node; i++)
         {
-            cerr << "  num_edge=" << Wmat[i]->size();
-            cerr << "  deg=" << deg_vec[i];
-            cerr << "  cap=" << bcap_vec[i];
+            solver_log() << "  num_edge=" << nbr_cnt_vec[i];
+            solver_log() << "  deg=" << deg_vec[i];
+            solver_log() << "  cap=" << bcap_vec[i];
             /* */
-            cerr << "  i=" << i ;
-            cerr << "  j:w=[";
+            solver_log() << "  i=" << i ;
+            solver_log() << "  j:w=[";
             j = 0;
-            for(svec=Wmat[i]->begin(); svec!=Wmat[i]->end(); svec++) {
+            for (s=row_begin_vec[i]; s<row_end_vec[i]; s++) {
+                if (!edge_live_vec[row_edge_vec[s]]) continue;
                 if (++j > 50) break;
-                cerr << " " << svec->first << ":" << svec->second << " "; 
+                solver_log() << " " << row_nbr_vec[s] << ":";
+                if (print_what==0) {
+                    solver_log() << 1 << " "; 
+                } else {
+                    solver_log() << edge_wgt_vec[row_edge_vec[s]] << " "; 
+                }
             }
-            if (svec!=Wmat[i]->end())    cerr << "... ";
-            cerr << "]" << endl;
+            if (s<row_end_vec[i])   solver_log() << "... ";
+            solver_log() << "]" << endl;
         }
     }
 
-
     if (print_what==3) {
-        cerr << "M_walk> = [";
+        solver_log() << "M_walk> = [";
         for (np=M_walk.begin(); np!=M_walk.end(); np++)
         {
-            cerr << " " << np->first << "," << np->second << " ";
+            solver_log() << " " << edge_u_vec[*np] << "," << edge_v_vec[*np] << " ";
         }
-        cerr << "]" << endl;
+        solver_log() << "]" << endl;
     }
 
     if (print_what==4) {
-        cerr << "B_match> = [";
+        solver_log() << "B_match> = [";
         for (np=B_match.begin(); np!=B_match.end(); np++)
         {
-            cerr << " " << np->first << "," << np->second << " ";
+            solver_log() << " " << edge_u_vec[*np] << "," << edge_v_vec[*np] << " ";
         }
-        cerr << "]" << endl;
+        solver_log() << "]" << endl;
     }
 }
 /* end print */
 
 
-/* initialize assuming 0-based indices for nodes */
+/* build the adjacency of an upper triangle ijw in (i,j) order without 
+ * duplicates, with all edges in the residual graph
+ *
+ * filling the rows in edge order leaves each row in increasing order: the 
+ * nbrs i<u of u come from edges (i,u) before the nbrs j>=u from edges (u,j)
+ * */
 void GreedyApproxBmatch::
-init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & ijw_vec) 
+build_graph(const int & in_num_node, const int & in_num_ijw, const DoubleVec & ijw_vec)
 {
-    register int i;
-
+    register int e;
     register int u;
     register int v;
-    register double wgt;
-    wgt = 0;
 
-    /* num nodes */
     num_node = in_num_node;
-    /* num ijw */
     num_ijw = in_num_ijw;
 
+    /* edges */
+    edge_u_vec.resize(num_ijw);
+    edge_v_vec.resize(num_ijw);
+    edge_wgt_vec.resize(num_ijw);
+    seeded_rank(num_ijw, seed, edge_rank_vec);
+    edge_alive_vec.assign(num_ijw, 1);
+    edge_live_vec.assign(num_ijw, 1);
+
+    /* row sizes (self-loops=1) */
+    row_begin_vec.assign(num_node+1, 0);
+    for (e=0; e<num_ijw; e++) 
+    {
+        u = int(ijw_vec[3*e + 0]);
+        v = int(ijw_vec[3*e + 1]);
+        edge_u_vec[e] = u;
+        edge_v_vec[e] = v;
+        edge_wgt_vec[e] = ijw_vec[3*e + 2];
+        row_begin_vec[u+1] += 1;
+        if (u!=v)
+        {
+            row_begin_vec[v+1] += 1;
+        }
+    }
+    for (u=0; u<num_node; u++)
+    {
+        row_begin_vec[u+1] += row_begin_vec[u];
+    }
+
+    /* fill rows */
+    row_nbr_vec.resize(row_begin_vec[num_node]);
+    row_edge_vec.resize(row_begin_vec[num_node]);
+    row_end_vec.assign(row_begin_vec.begin(), row_begin_vec.begin() + num_node);
+    for (e=0; e<num_ijw; e++) 
+    {
+        u = edge_u_vec[e];
+        v = edge_v_vec[e];
+        row_nbr_vec[row_end_vec[u]] = v;
+        row_edge_vec[row_end_vec[u]] = e;
+        row_end_vec[u] += 1;
+        if (u!=v)
+        {
+            row_nbr_vec[row_end_vec[v]] = u;
+            row_edge_vec[row_end_vec[v]] = e;
+            row_end_vec[v] += 1;
+        }
+    }
+}
+/* end build_graph */
+
+
+/* drop the edges that left the residual graph from the rows, keeping 
+ * the rows in increasing order */
+void GreedyApproxBmatch::
+compact_graph()
+{
+    register int u;
+    register int s;
+    register int t;
+
+    for (u=0; u<num_node; u++)
+    {
+        t = row_begin_vec[u];
+        for (s=row_begin_vec[u]; s<row_end_vec[u]; s++)
+        {
+            if (edge_alive_vec[row_edge_vec[s]])
+            {
+                row_nbr_vec[t] = row_nbr_vec[s];
+                row_edge_vec[t] = row_edge_vec[s];
+                t++;
+            }
+        }
+        row_end_vec[u] = t;
+    }
+}
+/* end compact_graph */
+
+
+/* start a round on the residual edges between nodes marked in keep_vec, 
+ * with capacities from the upper degree bounds */
+void GreedyApproxBmatch::
+start_round(const DoubleVec & deg_bdd_vec, const vector<bool> & keep_vec)
+{
+    register int i;
+    register int e;
+    register int u;
+    register int v;
+
     /* vector of node degree bounds */
-    bcap_vec = LongIntVec(num_node, 0);
+    bcap_vec.assign(num_node, 0);
 
     /* vector of node degrees */
-    deg_vec = LongIntVec(num_node, 0);
+    deg_vec.assign(num_node, 0);
+
+    /* vector of live nbrs */
+    nbr_cnt_vec.assign(num_node, 0);
+
+    /* live edges, and degrees w/ double counting for self-loops */
+    for (e=0; e<num_ijw; e++) 
+    {
+        u = edge_u_vec[e];
+        v = edge_v_vec[e];
+        edge_live_vec[e] = (edge_alive_vec[e] && keep_vec[u] && keep_vec[v]);
+        if (edge_live_vec[e])
+        {
+            deg_vec[u] += 1;
+            deg_vec[v] += 1;
+            nbr_cnt_vec[u] += 1;
+            if (u!=v)
+            {
+                nbr_cnt_vec[v] += 1;
+            }
+        }
+    }
+
+    /* ... node degree UPPER BOUNDS 
+     *
+     *  bcap_vec = deg_bdd(:,2)';
+     * */
+    /* N.B. index the SECOND COLUMN of deg_bdd_vec */
+    for (i=0; i<num_node; i++) {
+        bcap_vec[i] = int(deg_bdd_vec[2*i+1]);
+    }
+
+    /* ... node degree bounds, for the repair of the lower bounds */
+    lb_vec.assign(num_node, 0);
+    ub_vec.assign(num_node, 0);
+    for (i=0; i<num_node; i++) {
+        lb_vec[i] = int(deg_bdd_vec[2*i+0]);
+        ub_vec[i] = int(deg_bdd_vec[2*i+1]);
+    }
+
+    /* ... b-matchings (1- heavy / 2- light halves) with rows = (uu,vv,wgt)
+     *
+     * B_match = [];
+     * M_walk = [];
+     *  */
+    B_match.clear();
+    M_walk.clear();
+    start_node = 0;
+}
+/* end start_round */
+
+
+/* index of the live edge (u,v), or -1 */
+int GreedyApproxBmatch::
+find_edge(const int & u, const int & v) const
+{
+    register int lo;
+    register int hi;
+    register int mid;
+
+    /* binary search for v in the row of u */
+    lo = row_begin_vec[u];
+    hi = row_end_vec[u];
+    while (lo<hi)
+    {
+        mid = lo + (hi - lo)/2;
+        if (row_nbr_vec[mid]<v)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if ((lo<row_end_vec[u]) && (row_nbr_vec[lo]==v) && (edge_live_vec[row_edge_vec[lo]]))
+    {
+        return row_edge_vec[lo];
+    }
+    return -1;
+}
+/* end find_edge */
+
+
+/* remove an edge from the graph of the current round */
+void GreedyApproxBmatch::
+erase_edge(const int & e)
+{
+    if (!edge_live_vec[e])
+    {
+        return;
+    }
+    edge_live_vec[e] = 0;
+    nbr_cnt_vec[edge_u_vec[e]] -= 1;
+    if (edge_u_vec[e]!=edge_v_vec[e])
+    {
+        nbr_cnt_vec[edge_v_vec[e]] -= 1;
+    }
+}
+/* end erase_edge */
 
-    /* b-matchings */
-    /* B_match; */
 
+/* initialize assuming 0-based indices for nodes */
+void GreedyApproxBmatch::
+init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_vec, const int & in_num_ijw, const DoubleVec & ijw_vec) 
+{
     /* */
     verbose = in_verbose;
 
@@ -162,37 +346,8 @@ init(const int & in_verbose, const int& in_num_node, const DoubleVec & deg_bdd_v
      *
      * deg_vec = full(sum(Amat) + diag(Amat)');
      * */
-
-    ijw_2_svecvec_symm(num_ijw, ijw_vec, num_node, Amat);
-    ijw_2_svecvec_symm(num_ijw, ijw_vec, num_node, Wmat);
-    logical_svecvec(Amat);
-
-    /* get degrees w/ double counting for self-loops */
-    for (i=0; i<num_ijw; i++) 
-    {
-        u   = int(ijw_vec[3*i + 0]);
-        v   = int(ijw_vec[3*i + 1]);
-        deg_vec[u] += 1;
-        deg_vec[v] += 1;
-    }
-
-
-    /* ... node degree UPPER BOUNDS 
-     *
-     *  bcap_vec = deg_bdd(:,2)';
-     * */
-    /* N.B. index the SECOND COLUMN of deg_bdd_vec */
-    for (i=0; i<num_node; i++) {
-        bcap_vec[i] = int(deg_bdd_vec[2*i+1]);
-    }
-
-    /* ... b-matchings (1- heavy / 2- light halves) with rows = (uu,vv,wgt)
-     *
-     * B_match = [];
-     * M_walk = [];
-     *  */
-    B_match.clear();
-    M_walk.clear();
+    build_graph(in_num_node, in_num_ijw, ijw_vec);
+    start_round(deg_bdd_vec, vector<bool>(num_node, true));
 
 
     /* print */
@@ -209,35 +364,41 @@ int GreedyApproxBmatch::
 solve() 
 {
     register unsigned int i;
+    register int s;
     int     i_start_at;
 
     int     u;
     int     v;
-    int     u_nbr;
+    int     e;
+    int     e_max;
     int     deg_v;
     double  max_wgt;
 
-    SparseVecConstIterator  sv;
-    SparseVec *             nbrs_svec;
-    SparseVec *             wgt_svec;
-
     /* EdgeList    M_walk; */
     double      M1_weight;
     double      M2_weight;
+    int         num_walk = 0;
+    double      num_walk_edge = 0.0;
+    int         num_dead_end = 0;
+    int         num_bad_degree = 0;
 
     /* ... while there are nodes with degree capacity */
     while (1) {
 
         /* pick first node with pos. degree and pos. degree capacity bval 
          *  uu_node = find(bcap_vec&deg_vec,1);
+         *
+         * capacities and degrees only decrease, so the search resumes 
+         * where the last one stopped
          * */
-        for (u=0; u<num_node; u++)
+        for (u=start_node; u<num_node; u++)
         {
             if ((bcap_vec[u]>0) && (deg_vec[u]>0)) 
             {
                 break;
             }
         }
+        start_node = u;
 
         /*  if isempty(uu_node)
          *      break;
@@ -256,10 +417,6 @@ solve()
         /* ... walk */
         while (1) 
         {
-            /* */
-            nbrs_svec = Amat[u];
-            wgt_svec = Wmat[u];
-
             /* 
              *  bcap_vec(uu_node) = bcap_vec(uu_node) - 1;
              * */
@@ -271,11 +428,14 @@ solve()
              *      Amat(uu_node,uu_node) = 0.0;
              *  end
              * */
-            /* test u's existence in nbrs_svec w/o accidentally adding (u,0) */
-            if ((bcap_vec[u]==0) && (nbrs_svec->find(u)!=nbrs_svec->end()))
+            if (bcap_vec[u]==0)
             {
-                nbrs_svec->erase(u);
-                deg_vec[u] = int(max(0.0,deg_vec[u]-2.0));
+                e = find_edge(u, u);
+                if (e>=0)
+                {
+                    erase_edge(e);
+                    deg_vec[u] = int(max(0.0,deg_vec[u]-2.0));
+                }
             }
             
             /*
@@ -290,31 +450,42 @@ solve()
             }
             
             /* 
-             * ... get heaviest edge (u,v) 
+             * ... get heaviest edge (u,v), of lowest rank among equal
+             * weights, i.e. the first in nbr order when seed is 0
              * I_uu_nbrs = find(Amat(:,uu_node));
              * [max_wgt, vv_node] = max(Wmat(I_uu_nbrs,uu_node));
              * vv_node = I_uu_nbrs(vv_node);
              * */
-            sv      = nbrs_svec->begin();
-            v       = sv->first;
-            max_wgt = (*wgt_svec)[v];
-            /* */
-            for (sv++; sv!=nbrs_svec->end(); sv++) 
+            e_max   = -1;
+            v       = u;
+            max_wgt = 0.0;
+            for (s=row_begin_vec[u]; s<row_end_vec[u]; s++) 
             {
-                u_nbr = sv->first;
-                if ((*wgt_svec)[u_nbr]>max_wgt) {
-                    v = u_nbr;
-                    max_wgt = (*wgt_svec)[u_nbr];
+                e = row_edge_vec[s];
+                if (!edge_live_vec[e])
+                {
+                    continue;
+                }
+                if ((e_max<0) || (edge_wgt_vec[e]>max_wgt) || 
+                    ((edge_wgt_vec[e]==max_wgt) && (edge_rank_vec[e]<edge_rank_vec[e_max]))) {
+                    e_max = e;
+                    v = row_nbr_vec[s];
+                    max_wgt = edge_wgt_vec[e];
                 }
             }
+            if (e_max<0)
+            {
+                /* deg_vec[u] counts an edge that is no longer live */
+                num_dead_end += 1;
+                break;
+            }
             
             /*
              * ... remove (u,v) from G 
              * Amat(vv_node,uu_node) = 0.0;
              * Amat(uu_node,vv_node) = 0.0;
              * */
-            Amat[u]->erase(v);
-            Amat[v]->erase(u);
+            erase_edge(e_max);
             
             /*
              * ... decrease degrees of uu, vv 
@@ -337,12 +508,18 @@ solve()
                  * 
                  * ... decrease degrees of all xx nbrs of uu 
                  * deg_vec(I_uu_nbrs) = deg_vec(I_uu_nbrs) - 1;
+                 *
+                 * ... remove (uu,xx) for all xx nbrs of uu 
+                 * Amat(uu_node,I_uu_nbrs) = 0.0;
                  * */
-                for (sv=nbrs_svec->begin(); sv!=nbrs_svec->end(); sv++) 
+                for (s=row_begin_vec[u]; s<row_end_vec[u]; s++) 
                 {
-                    u_nbr = sv->first;
-                    Amat[u_nbr]->erase(u);
-                    deg_vec[u_nbr] -= 1;
+                    e = row_edge_vec[s];
+                    if (edge_live_vec[e])
+                    {
+                        erase_edge(e);
+                        deg_vec[row_nbr_vec[s]] -= 1;
+                    }
                 }
                 /* 
                  * ... increment vv degree because decremented twice (matlab)
@@ -352,11 +529,6 @@ solve()
                  * deg_vec[v] += 1;
                  * */
 
-                /*
-                 * ... remove (uu,xx) for all xx nbrs of uu 
-                 * Amat(uu_node,I_uu_nbrs) = 0.0;
-                 * */
-                nbrs_svec->clear();
                 /*
                  * ... ensure that uu_node degree is zero 
                  * (even when uu_node==vv_node) 
@@ -367,33 +539,28 @@ solve()
                  * testing ... remove for efficiency later 
                  *  assert(all(deg_vec==[sum(Amat) + diag(Amat)']));
                  * */
-                /* check existence w/o accidentally adding element */
-                /* test v's existence in Amat[v] w/o accidentally adding (v,0)*/
-                deg_v = Amat[v]->size();
-                if (Amat[v]->find(v)!=Amat[v]->end())
+                deg_v = nbr_cnt_vec[v];
+                if (find_edge(v, v)>=0)
                 {
                     deg_v += 1;
                 }
                 if (deg_vec[v]!=deg_v) 
                 {
-                    cerr << " -XXX- " << endl;
+                    /* deg_vec[v] is out of step with the live edges of v */
+                    num_bad_degree += 1;
                 }
 
             } /* end */
             
             /* 
-             * add edge (u,v) to path 
+             * add edge (u,v) to path, edges being stored with u<=v
              *  if uu_node<=vv_node
              *      M_walk(end+1,:) = [uu_node,vv_node,max_wgt];
              *  else
              *      M_walk(end+1,:) = [vv_node,uu_node,max_wgt];
              *  end
              * */
-            if (u<=v) {
-                M_walk.push_back(NodePair(u,v));
-            } else {
-                M_walk.push_back(NodePair(v,u));
-            }
+            M_walk.push_back(e_max);
 
 
             /*
@@ -423,6 +590,8 @@ solve()
          *  if size(M_walk,1)>0
          * */
         if (M_walk.size()>0) {
+            num_walk += 1;
+            num_walk_edge += double(M_walk.size());
             /*
              * ... first, split walk into two 
              *  M1_walk = M_walk(1:2:end,:);
@@ -430,11 +599,11 @@ solve()
              * */
             M1_weight = 0.0;
             for (i=0; i<M_walk.size(); i=i+2) {
-                M1_weight += (*Wmat[M_walk[i].first])[M_walk[i].second];
+                M1_weight += edge_wgt_vec[M_walk[i]];
             }
             M2_weight = 0.0;
             for (i=1; i<M_walk.size(); i=i+2) {
-                M2_weight += (*Wmat[M_walk[i].first])[M_walk[i].second];
+                M2_weight += edge_wgt_vec[M_walk[i]];
             }
             /*
              * ... append heavy half-walk to heavy b-match, 
@@ -457,6 +626,24 @@ solve()
         } /* end append walk */ 
 
     } /* end while nodes with capacity */
+    profile.count("greedy_walks", num_walk);
+    profile.count("greedy_walk_edges", num_walk_edge);
+    if (num_dead_end>0)
+    {
+        profile.count("greedy_dead_ends", num_dead_end);
+        if (verbose>0)
+        {
+            solver_log() << " GreedyApproxBmatch> " << num_dead_end << " walks stopped at a node without live edges" << endl;
+        }
+    }
+    if (num_bad_degree>0)
+    {
+        profile.count("greedy_bad_degrees", num_bad_degree);
+        if (verbose>0)
+        {
+            solver_log() << " GreedyApproxBmatch> " << num_bad_degree << " walk steps left a degree count out of step" << endl;
+        }
+    }
 
 
     /* 
@@ -464,6 +651,14 @@ solve()
      *  ijw_out = B_match;
      * */
 
+    /* ... fill the nodes below their lower bounds */
+    lb_deficit = repair_lower_bounds();
+    if ((lb_deficit>0) && report_deficit)
+    {
+        solver_log() << " GreedyApproxBmatch!> lower bounds not met, total deficit " << lb_deficit << endl;
+        profile.count("lb_deficit", lb_deficit);
+    }
+
 
     /* 
      * verbose output
@@ -478,18 +673,176 @@ solve()
 /* end solve */
 
 
+/* raise the matched degrees of B_match to the lower bounds of the round
+ *
+ * a node u below its lower bound takes, in turn, the unmatched edge (u,v) 
+ * of the round of largest gain: the weight of (u,v) if v has spare 
+ * capacity, or else less the weight of the lightest matched edge (v,x) 
+ * that v gives up, x being above its lower bound; nodes at or above their 
+ * lower bounds stay there, and no node exceeds its upper bound
+ *
+ * returns the total deficit left, 0 if the lower bounds are met
+ * */
+int GreedyApproxBmatch::
+repair_lower_bounds()
+{
+    register int u;
+    register int k;
+    register int s;
+    register int t;
+    int     e;
+    int     f;
+    int     v;
+    int     x;
+    int     best_e;
+    int     best_f;
+    int     deficit;
+    int     num_repair;
+    double  gain;
+    double  best_gain;
+    vector<char> match_vec;
+    LongIntVec md_vec;
+    EdgeIndexList add_list;
+
+    /* nothing to do without lower bounds */
+    for (u=0; u<num_node; u++)
+    {
+        if (lb_vec[u]>0)
+        {
+            break;
+        }
+    }
+    if (u==num_node)
+    {
+        return 0;
+    }
+
+    /* matched edges and degrees (self-loops=2) */
+    match_vec.assign(num_ijw, 0);
+    md_vec.assign(num_node, 0);
+    for (k=0; k<int(B_match.size()); k++)
+    {
+        e = B_match[k];
+        match_vec[e] = 1;
+        md_vec[edge_u_vec[e]] += 1;
+        md_vec[edge_v_vec[e]] += 1;
+    }
+
+    num_repair = 0;
+    for (u=0; u<num_node; u++)
+    {
+        while (md_vec[u]<lb_vec[u])
+        {
+            best_e = -1;
+            best_f = -1;
+            best_gain = 0.0;
+            for (s=row_begin_vec[u]; s<row_end_vec[u]; s++)
+            {
+                e = row_edge_vec[s];
+                v = row_nbr_vec[s];
+                if (match_vec[e] || (!edge_alive_vec[e]) || (ub_vec[u]==0) || (ub_vec[v]==0))
+                {
+                    continue;
+                }
+                f = -1;
+                if (v==u)
+                {
+                    /* a self-loop needs two free slots */
+                    if (md_vec[u] + 2>ub_vec[u])
+                    {
+                        continue;
+                    }
+                    gain = edge_wgt_vec[e];
+                }
+                else if (md_vec[v]<ub_vec[v])
+                {
+                    gain = edge_wgt_vec[e];
+                }
+                else
+                {
+                    /* lightest matched edge (v,x) that x can give up */
+                    for (t=row_begin_vec[v]; t<row_end_vec[v]; t++)
+                    {
+                        x = row_nbr_vec[t];
+                        if ((!match_vec[row_edge_vec[t]]) || (x==v) || (x==u) || (md_vec[x]<=lb_vec[x]))
+                        {
+                            continue;
+                        }
+                        if ((f<0) || (edge_wgt_vec[row_edge_vec[t]]<edge_wgt_vec[f]) || 
+                            ((edge_wgt_vec[row_edge_vec[t]]==edge_wgt_vec[f]) && (edge_rank_vec[row_edge_vec[t]]<edge_rank_vec[f])))
+                        {
+                            f = row_edge_vec[t];
+                        }
+                    }
+                    if (f<0)
+                    {
+                        continue;
+                    }
+                    gain = edge_wgt_vec[e] - edge_wgt_vec[f];
+                }
+                if ((best_e<0) || (gain>best_gain) || ((gain==best_gain) && (edge_rank_vec[e]<edge_rank_vec[best_e])))
+                {
+                    best_e = e;
+                    best_f = f;
+                    best_gain = gain;
+                }
+            }
+            if (best_e<0)
+            {
+                break;
+            }
+
+            /* swap */
+            match_vec[best_e] = 1;
+            md_vec[edge_u_vec[best_e]] += 1;
+            md_vec[edge_v_vec[best_e]] += 1;
+            if (best_f>=0)
+            {
+                match_vec[best_f] = 0;
+                md_vec[edge_u_vec[best_f]] -= 1;
+                md_vec[edge_v_vec[best_f]] -= 1;
+            }
+            add_list.push_back(best_e);
+            num_repair += 1;
+        }
+    }
+    deficit = 0;
+    for (u=0; u<num_node; u++)
+    {
+        deficit += max(0, int(lb_vec[u] - md_vec[u]));
+    }
+
+    /* B_match less the edges given up, then the edges added, once each */
+    B_match.insert(B_match.end(), add_list.begin(), add_list.end());
+    add_list.clear();
+    for (k=0; k<int(B_match.size()); k++)
+    {
+        e = B_match[k];
+        if (match_vec[e])
+        {
+            match_vec[e] = 0;
+            add_list.push_back(e);
+        }
+    }
+    B_match.swap(add_list);
+    profile.count("lb_repairs", num_repair);
+    return deficit;
+}
+/* end repair_lower_bounds */
+
+
 /* copy b-matching approx solution using 0-based indices for nodes */
 void GreedyApproxBmatch::
 solution(const int & num_bmatch_edge, DoubleVec & bmatch_edge_vec) 
 {
-    EdgeList::iterator np;
+    EdgeIndexList::iterator np;
 
     bmatch_edge_vec.clear();
     bmatch_edge_vec.reserve(3*num_bmatch_edge);
     for (np=B_match.begin(); np!=B_match.end(); np++)
     {
-        bmatch_edge_vec.push_back(np->first);
-        bmatch_edge_vec.push_back(np->second);
+        bmatch_edge_vec.push_back(edge_u_vec[*np]);
+        bmatch_edge_vec.push_back(edge_v_vec[*np]);
         bmatch_edge_vec.push_back(1.0);
     }
 }
@@ -506,162 +859,239 @@ RecursiveGreedyApproxBmatch::
 
 
 
-/* solve_bmatching_problem */
+/* solve_bmatching_view
+ *
+ * each round solves the greedy problem on the residual graph, i.e. the 
+ * input graph less the edges matched so far, with the degree bounds less 
+ * the matched degrees, and stops when a round adds no edges; the rounds 
+ * reproduce the former recursion, one level per round, including its 
+ * weights summed from the deepest level up
+ * */
 int RecursiveGreedyApproxBmatch::
-solve_bmatching_problem(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const DoubleVec & in_ijw_vec, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+solve_bmatching_view(const int & in_num_node, const DoubleVec & in_deg_bdd_vec, const int & in_num_ijw, const IjwView & in_ijw_view, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
 {
     register int i;
-    register int j;
     register int k;
+    register int e;
+    register int u;
+    register int v;
 
-    int success;
-    int recur_success;
+    int round;
+    int num_round_edge;
 
     int     L_num_node = in_num_node;
-    int     L_num_ijw = in_num_ijw;
-    DoubleVec L_ijw_vec = in_ijw_vec;
-    DoubleVec L_deg_bdd_vec = in_deg_bdd_vec;
+    int     L_num_ijw = 0;
+    DoubleVec L_ijw_vec;
+    DoubleVec L_deg_bdd_vec = in_deg_bdd_vec;   /* of residual graph */
+    DoubleVec R_deg_bdd_vec;                    /* of a round */
 
     /* degrees */
-    DoubleVec deg_vec(L_num_node, 0);     /* of input graph */
-    DoubleVec bmatch_deg_vec(L_num_node, 0);     /* of bmatch subgraph */
+    DoubleVec deg_vec(L_num_node, 0);     /* of residual graph */
+    DoubleVec round_deg_vec(L_num_node, 0);     /* of the graph of a round */
 
-    /* adjacency and weights */
-    SparseVecVec AAmat;
-    SparseVecVec BBmat;
-    SparseVecVec WWmat;
-    SparseVecIterator sp;
+    /* nodes kept */
+    vector<bool> keep_vec(L_num_node, true);
 
-    /* recursive input */
-    int         num_recur_edge;
-    DoubleVec   recur_edge_vec;
-    double      recur_wgt;
+    /* weights of the rounds */
+    DoubleVec round_wgt_vec;
+
+    /* lower bounds of the first round, and the deficit left */
+    DoubleVec lb_vec;
+    int deficit;
 
     /* */
     num_bmatch_edge = 0;
     bmatch_edge_vec.clear();
 
-    /* remove edges that are incident to nodes with upper bound at zero */
-    ijw_2_svecvec_symm(L_num_ijw, L_ijw_vec, L_num_node, AAmat);
-
+    /* remove edges that are incident to nodes with upper bound at zero, 
+     * and extract the upper triangle ijw in (i,j) order */
+    profile.start("preprocess");
     for (i=0; i<L_num_node; i++)
     {
-        if (L_deg_bdd_vec[2*i + 1]==0)
-        {
-            AAmat[i]->clear();
-            for (j=0; j<L_num_node; j++) 
-            {
-                AAmat[j]->erase(i);
-            }
-        }
-    }
-    /* extract updated upper triangle ijw */
-    svecvec_2_ijw(L_num_node, AAmat, L_num_ijw, L_ijw_vec);
-    ijw_upper_tri(L_num_ijw,L_ijw_vec,0);
-    
-    /* make AAmat logical */
-    logical_svecvec(AAmat);
-
-    /* compute degree (self-loops=2)*/
-    for (k=0; k<L_num_ijw; k++) {
-        i = int(L_ijw_vec[3*k+0]);
-        j = int(L_ijw_vec[3*k+1]);
-        deg_vec[i] += 1;
-        deg_vec[j] += 1;
-    }
-    /* ensure validity of bounds */
-    for (i=0; i<L_num_node; i++) 
-    {
-        L_deg_bdd_vec[2*i+0] = max(0.0, min(L_deg_bdd_vec[2*i+0], deg_vec[i]));
-        L_deg_bdd_vec[2*i+1] = max(0.0, min(L_deg_bdd_vec[2*i+1], deg_vec[i]));
+        keep_vec[i] = (L_deg_bdd_vec[2*i + 1]!=0);
     }
+    ijw_keep_upper_tri(in_ijw_view, in_num_ijw, keep_vec, L_num_ijw, L_ijw_vec);
 
-    /* debug */
-    if (verbose>2)
-    {
-        cerr << "ijw_vec:" << endl;
-        write_mn_matrix(cerr, L_num_ijw, 3, L_ijw_vec, 4);
-        cerr << "deg_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 1, deg_vec, 4);
-        cerr << "deg_bdd_vec:" << endl;
-        write_mn_matrix(cerr, L_num_node, 2, L_deg_bdd_vec, 4);
+    /* check for positive wgts */
+    for (k=0; k<L_num_ijw; k++) {
+        if (L_ijw_vec[3*k + 2]<0) {
+            solver_log() << " bmatch_ijw!> weights must be positive " << endl;
+            profile.stop("preprocess");
+            return 0;
+        }
     }
+    profile.stop("preprocess");
 
+    /* the residual graph */
+    profile.start("init");
+    build_graph(L_num_node, L_num_ijw, L_ijw_vec);
+    profile.stop("init");
 
-    /* */
-    success = GreedyApproxBmatch::solve_bmatching_problem(L_num_node, L_deg_bdd_vec, L_num_ijw, L_ijw_vec, num_bmatch_edge, bmatch_edge_vec, bmatch_wgt, verbose);
-
-    /* */
-    if ((success) && (num_bmatch_edge>0))
+    for (round=0; ; round++)
     {
-        /* setup recursion */
+        profile.start("preprocess");
 
-        /* matching: sparse symmetric adjacency */
-        ijw_2_svecvec_symm(num_bmatch_edge, bmatch_edge_vec, in_num_node, BBmat);
-        logical_svecvec(BBmat);
+        /* remove edges that are incident to nodes with upper bound at zero */
+        if (round>0)
+        {
+            for (e=0; e<num_ijw; e++)
+            {
+                if ((L_deg_bdd_vec[2*edge_u_vec[e] + 1]==0) || (L_deg_bdd_vec[2*edge_v_vec[e] + 1]==0))
+                {
+                    edge_alive_vec[e] = 0;
+                }
+            }
+            compact_graph();
+        }
 
         /* compute degree (self-loops=2)*/
-        for (k=0; k<num_bmatch_edge; k++) {
-            i = int(bmatch_edge_vec[3*k+0]);
-            j = int(bmatch_edge_vec[3*k+1]);
-            bmatch_deg_vec[i] += 1;
-            bmatch_deg_vec[j] += 1;
+        deg_vec.assign(L_num_node, 0);
+        for (e=0; e<num_ijw; e++) {
+            if (edge_alive_vec[e])
+            {
+                deg_vec[edge_u_vec[e]] += 1;
+                deg_vec[edge_v_vec[e]] += 1;
+            }
         }
-
-        /* A_residual = A - B */
+        /* ensure validity of bounds */
         for (i=0; i<L_num_node; i++) 
         {
-            for (sp=BBmat[i]->begin(); sp!=BBmat[i]->end(); sp++) 
+            L_deg_bdd_vec[2*i+0] = max(0.0, min(L_deg_bdd_vec[2*i+0], deg_vec[i]));
+            L_deg_bdd_vec[2*i+1] = max(0.0, min(L_deg_bdd_vec[2*i+1], deg_vec[i]));
+        }
+
+        /* the graph of the round drops the nodes whose upper bound is 
+         * now zero, and the bounds are made valid for it */
+        R_deg_bdd_vec = L_deg_bdd_vec;
+        for (i=0; i<L_num_node; i++)
+        {
+            keep_vec[i] = (R_deg_bdd_vec[2*i + 1]!=0);
+        }
+        round_deg_vec.assign(L_num_node, 0);
+        for (e=0; e<num_ijw; e++) {
+            if (edge_alive_vec[e] && keep_vec[edge_u_vec[e]] && keep_vec[edge_v_vec[e]])
             {
-                j = sp->first;
-                AAmat[i]->erase(j);
+                round_deg_vec[edge_u_vec[e]] += 1;
+                round_deg_vec[edge_v_vec[e]] += 1;
             }
         }
-        /* W_residual = A_residual.*WWmat */
-        ijw_2_svecvec_symm(in_num_ijw, in_ijw_vec, in_num_node, WWmat);
-
         for (i=0; i<L_num_node; i++) 
-        {
-            for (sp=AAmat[i]->begin(); sp!=AAmat[i]->end(); sp++) 
+        { 
+            R_deg_bdd_vec[2*i+0] = max(0.0, min(R_deg_bdd_vec[2*i+0],round_deg_vec[i]));
+            R_deg_bdd_vec[2*i+1] = max(0.0, min(R_deg_bdd_vec[2*i+1],round_deg_vec[i]));
+            if (R_deg_bdd_vec[2*i+0] > R_deg_bdd_vec[2*i+1])
             {
-                j = sp->first;
-                sp->second = (*WWmat[i])[j];
+                solver_log() << " BmatchSolver!> LB > UB" << endl;
+                break;
             }
         }
-        /* ijw_vec = find(triu(W_residual)) */
-        svecvec_2_ijw(L_num_node, AAmat, L_num_ijw, L_ijw_vec);
-        ijw_upper_tri(L_num_ijw,L_ijw_vec,0);
 
-        /* deg_bdd = L_deg_bdd_vec - bmatch_deg_vec; */
-        for (i=0; i<L_num_node; i++)
+        /* debug */
+        if (verbose>2)
         {
-            L_deg_bdd_vec[2*i + 0] = L_deg_bdd_vec[2*i + 0] - bmatch_deg_vec[i];
-            L_deg_bdd_vec[2*i + 1] = L_deg_bdd_vec[2*i + 1] - bmatch_deg_vec[i];
+            solver_log() << "round " << round << " deg_vec:" << endl;
+            write_mn_matrix(solver_log(), L_num_node, 1, round_deg_vec, 4);
+            solver_log() << "deg_bdd_vec:" << endl;
+            write_mn_matrix(solver_log(), L_num_node, 2, R_deg_bdd_vec, 4);
         }
+        profile.stop("preprocess");
 
+        /* a failed first round fails, a failed later round adds no edges */
+        if (i<L_num_node)
+        {
+            if (round==0)
+            {
+                return 0;
+            }
+            break;
+        }
 
-        /* recurse and merge any additional edges */
-        RecursiveGreedyApproxBmatch * ALG = new RecursiveGreedyApproxBmatch();
-        recur_success = ALG->solve_bmatching_problem(L_num_node, L_deg_bdd_vec, L_num_ijw, L_ijw_vec, num_recur_edge, recur_edge_vec, recur_wgt, verbose);
-        delete ALG;
+        /* the lower bounds to meet, less the matched degrees */
+        if (round==0)
+        {
+            lb_vec.resize(L_num_node);
+            for (i=0; i<L_num_node; i++)
+            {
+                lb_vec[i] = R_deg_bdd_vec[2*i+0];
+            }
+        }
 
-        /* append to bmatch_edge_vec */
-        if ((recur_success) && (num_recur_edge>0))
+        /* initialize */
+        profile.start("init");
+        GreedyApproxBmatch::verbose = max(verbose-1,0);
+        start_round(R_deg_bdd_vec, keep_vec);
+        profile.stop("init");
+
+        /* solve problem */
+        profile.start("solve");
+        num_round_edge = solve();
+        profile.stop("solve");
+        if (verbose>1) 
         {
-            bmatch_edge_vec.insert(bmatch_edge_vec.end(), recur_edge_vec.begin(), recur_edge_vec.end());
-            num_bmatch_edge += num_recur_edge;
-            bmatch_wgt      += recur_wgt;
+            solver_log() << endl;
+        }
+        if (verbose>0) 
+        {
+            solver_log() << " bmatch_ijw> returning ";
+            solver_log() << num_round_edge << " edges" << endl;
+        }
+        if (num_round_edge==0)
+        {
+            break;
         }
-    }
 
-    /* local cleanup */
-    delete_svecvec(AAmat);
-    delete_svecvec(BBmat);
-    delete_svecvec(WWmat);
+        /* append the matching of the round, and remove it from the 
+         * residual graph and its degree bounds */
+        profile.start("solution");
+        bmatch_edge_vec.reserve(bmatch_edge_vec.size() + 3*num_round_edge);
+        for (k=0; k<num_round_edge; k++)
+        {
+            e = B_match[k];
+            u = edge_u_vec[e];
+            v = edge_v_vec[e];
+            bmatch_edge_vec.push_back(u);
+            bmatch_edge_vec.push_back(v);
+            bmatch_edge_vec.push_back(1.0);
+            edge_alive_vec[e] = 0;
+            lb_vec[u] -= 1;
+            lb_vec[v] -= 1;
+            L_deg_bdd_vec[2*u + 0] -= 1;
+            L_deg_bdd_vec[2*u + 1] -= 1;
+            L_deg_bdd_vec[2*v + 0] -= 1;
+            L_deg_bdd_vec[2*v + 1] -= 1;
+        }
+        num_bmatch_edge += num_round_edge;
+        profile.stop("solution");
 
-    return success;
-}
-/* end solve_bmatching_problem */
+        /* compute weight */
+        profile.start("weight");
+        round_wgt_vec.push_back(0.0);
+        for (k=0; k<num_round_edge; k++) 
+        {
+            round_wgt_vec.back() += edge_wgt_vec[B_match[k]];
+        }
+        profile.stop("weight");
+    }
 
+    /* report the lower bounds that the rounds did not meet */
+    deficit = 0;
+    for (i=0; i<L_num_node; i++)
+    {
+        deficit += int(max(0.0, lb_vec[i]));
+    }
+    if (deficit>0)
+    {
+        solver_log() << " GreedyApproxBmatch!> lower bounds not met, total deficit " << deficit << endl;
+        profile.count("lb_deficit", deficit);
+    }
 
+    /* sum the weights of the rounds as the recursion did, w0 + (w1 + ...) */
+    bmatch_wgt = 0.0;
+    for (k=int(round_wgt_vec.size())-1; k>=0; k--)
+    {
+        bmatch_wgt = round_wgt_vec[k] + bmatch_wgt;
+    }
 
+    return 1;
+}
+/* end solve_bmatching_view */
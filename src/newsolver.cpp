@@ -0,0 +1,52 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include "newsolver.hpp"
+#include "goblinexact.hpp"
+#include "greedyapprox.hpp"
+#include "beliefprop.hpp"
+#include "bsuitor.hpp"
+#include "bipartite.hpp"
+
+
+/* */
+AbstractBmatchSolver * new_solver(const int & method, const Parameter & PP)
+{
+    GoblinExactBmatch * GALG;
+    ComplementaryGoblinExactBmatch * CALG;
+    BSuitorApproxBmatch * SALG;
+    BipartiteFlowBmatch * BALG;
+
+    switch (method) {
+        case 1: 
+            CALG = new ComplementaryGoblinExactBmatch();
+            CALG->prune = PP.prune;
+            CALG->meth_pq = max(PP.queue, GOBLIN_PQ_AUTO);
+            CALG->meth_primal_dual = PP.primal_dual;
+            return CALG;
+        case 2: 
+            GALG = new GoblinExactBmatch();
+            GALG->meth_pq = max(PP.queue, GOBLIN_PQ_AUTO);
+            GALG->meth_primal_dual = PP.primal_dual;
+            return GALG;
+        case 3: 
+            return new GreedyApproxBmatch();
+        case 4: 
+            return new RecursiveGreedyApproxBmatch();
+        case 5: 
+            return new BeliefPropBmatch();
+        case 6: 
+            SALG = new BSuitorApproxBmatch();
+            SALG->num_thread = PP.threads;
+            return SALG;
+        case 7: 
+            BALG = new BipartiteFlowBmatch();
+            BALG->num_left = PP.bipartite;
+            return BALG;
+        default:
+            return NULL;
+    }
+}
+/* end new_solver */
+
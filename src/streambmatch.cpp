@@ -0,0 +1,198 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <cmath>
+#include <cstdlib>
+#include "streambmatch.hpp"
+
+
+/* */
+string StreamBmatch::
+description()
+{
+    return description_str;
+}
+
+
+/* upper bound of node u, negative if unknown */
+int StreamBmatch::
+upper_bound(const DoubleVec & deg_bdd_vec, const int & u) const
+{
+    if (2*u+1<int(deg_bdd_vec.size()))
+    {
+        return max(0, int(deg_bdd_vec[2*u+1]));
+    }
+    if (const_ub>=0)
+    {
+        return int(const_ub);
+    }
+    return -1;
+}
+/* end upper_bound */
+
+
+/* read IJW entries from in and b-match them */
+int StreamBmatch::
+solve_bmatching_stream(istream & in, const DoubleVec & deg_bdd_vec, int & num_node, double & num_entry, int & num_bmatch_edge, DoubleVec & bmatch_edge_vec, double & bmatch_wgt, const int & verbose)
+{
+    register int k;
+    int     u;
+    int     v;
+    int     ub_u;
+    int     ub_v;
+    int     cls;
+    int     cnt_u;
+    int     cnt_v;
+    int     num_class;
+    double  wgt;
+    double  log_base;
+    const char * ptr;
+    char *  end;
+    string  line;
+    vector<int> count_vec;
+    map<pair<int,int>,double> match_map;
+    map<pair<int,int>,double>::iterator mp;
+    map<int,StreamWeightClass>::reverse_iterator cp;
+    StreamWeightClass * wc;
+
+    num_node = int(deg_bdd_vec.size()/2);
+    num_entry = 0;
+    num_bmatch_edge = 0;
+    bmatch_edge_vec.clear();
+    bmatch_wgt = 0.0;
+    class_map.clear();
+    log_base = log(1.0 + eps);
+    if (!(log_base>0))
+    {
+        solver_log() << " StreamBmatch!> eps must be positive" << endl;
+        return 0;
+    }
+
+    /* one pass: a maximal b-matching per weight class */
+    profile.start("stream");
+    while (getline(in, line))
+    {
+        if (line.size()==0)
+        {
+            break;
+        }
+        ptr = line.c_str();
+        u = int(strtod(ptr, &end));
+        if (end==ptr)
+        {
+            /* whitespace */
+            continue;
+        }
+        ptr = end;
+        v = int(strtod(ptr, &end));
+        if (end!=ptr)
+        {
+            ptr = end;
+            wgt = strtod(ptr, &end);
+        }
+        if (end==ptr)
+        {
+            solver_log() << " StreamBmatch!> entry " << num_entry + 1 << " must have 3 columns" << endl;
+            profile.stop("stream");
+            return 0;
+        }
+        num_entry += 1;
+
+        if (wgt<0)
+        {
+            solver_log() << " bmatch_ijw!> weights must be positive " << endl;
+            profile.stop("stream");
+            return 0;
+        }
+        if ((u<0) || (v<0))
+        {
+            solver_log() << " StreamBmatch!> negative node index" << endl;
+            profile.stop("stream");
+            return 0;
+        }
+        num_node = max(num_node, max(u, v) + 1);
+        if ((u>v) || (wgt==0))
+        {
+            continue;
+        }
+        ub_u = upper_bound(deg_bdd_vec, u);
+        ub_v = upper_bound(deg_bdd_vec, v);
+        if ((ub_u<0) || (ub_v<0))
+        {
+            solver_log() << "bmatch!> missing nodes in degree bounds" << endl;
+            profile.stop("stream");
+            return 0;
+        }
+
+        /* maximal b-matching of the class (self-loops=2) */
+        cls = int(floor(log(wgt)/log_base));
+        wc = &class_map[cls];
+        cnt_u = wc->count_map[u];
+        cnt_v = (u==v) ? cnt_u : wc->count_map[v];
+        if ((u==v) ? (cnt_u + 2>ub_u) : ((cnt_u>=ub_u) || (cnt_v>=ub_v)))
+        {
+            continue;
+        }
+        wc->count_map[u] += 1;
+        wc->count_map[v] += 1;
+        wc->edge_u_vec.push_back(u);
+        wc->edge_v_vec.push_back(v);
+        wc->edge_wgt_vec.push_back(wgt);
+    }
+    profile.stop("stream");
+    profile.count("stream_entries", num_entry);
+    profile.count("stream_classes", class_map.size());
+
+    /* combine the classes, heaviest first, skipping duplicates */
+    profile.start("solve");
+    num_class = int(class_map.size());
+    count_vec.assign(num_node, 0);
+    for (cp=class_map.rbegin(); cp!=class_map.rend(); cp++)
+    {
+        wc = &cp->second;
+        for (k=0; k<int(wc->edge_u_vec.size()); k++)
+        {
+            u = wc->edge_u_vec[k];
+            v = wc->edge_v_vec[k];
+            if ((u==v) ? (count_vec[u] + 2>upper_bound(deg_bdd_vec, u)) :
+                ((count_vec[u]>=upper_bound(deg_bdd_vec, u)) || (count_vec[v]>=upper_bound(deg_bdd_vec, v))))
+            {
+                continue;
+            }
+            if (match_map.find(make_pair(u, v))!=match_map.end())
+            {
+                continue;
+            }
+            count_vec[u] += 1;
+            count_vec[v] += 1;
+            match_map[make_pair(u, v)] = wc->edge_wgt_vec[k];
+        }
+        wc->count_map.clear();
+    }
+    class_map.clear();
+    profile.stop("solve");
+
+    /* solution in (i,j) order */
+    profile.start("solution");
+    bmatch_edge_vec.reserve(3*match_map.size());
+    for (mp=match_map.begin(); mp!=match_map.end(); mp++)
+    {
+        bmatch_edge_vec.push_back(mp->first.first);
+        bmatch_edge_vec.push_back(mp->first.second);
+        bmatch_edge_vec.push_back(1.0);
+        bmatch_wgt += mp->second;
+    }
+    num_bmatch_edge = int(match_map.size());
+    profile.stop("solution");
+
+    if (verbose>0)
+    {
+        solver_log() << " StreamBmatch> " << num_entry << " entries, ";
+        solver_log() << num_class << " weight classes" << endl;
+        solver_log() << " bmatch_ijw> returning " << num_bmatch_edge << " edges" << endl;
+    }
+    return 1;
+}
+/* end solve_bmatching_stream */
+
@@ -0,0 +1,469 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "synthetic.hpp"
+
+
+/* seed of the stream of chunk c, scrambled so that the streams of nearby
+ * chunks are not correlated */
+static unsigned int synthetic_chunk_seed(const unsigned int & seed, const int & c)
+{
+    unsigned int h;
+    h = seed ^ ((unsigned int)(c + 1)*2654435769u);
+    h ^= h >> 16;
+    h *= 2246822507u;
+    h ^= h >> 13;
+    h *= 3266489909u;
+    h ^= h >> 16;
+    return (h!=0) ? h : 1;
+}
+/* end synthetic_chunk_seed */
+
+
+/* set up the chunks, and the points or node weights */
+int SyntheticGraph::
+init()
+{
+    register int i;
+    register int k;
+    int         c;
+    int         n_chunk;
+    int         num_left;
+    double      total;
+    double      sum;
+    DoubleVec   row_vec;
+    vector<int> cell_end_vec;
+    SyntheticRand rnd(seed);
+
+    if ((num_node<0) || (kind<1) || (kind>SYNTHETIC_NUM_KIND) || (wgt_kind<1) || (wgt_kind>SYNTHETIC_WGT_NUM_KIND))
+    {
+        cerr << "SyntheticGraph!> unknown kind of graph or weights" << endl;
+        return 0;
+    }
+    if ((wgt_kind==SYNTHETIC_WGT_DIST) && (kind!=SYNTHETIC_KNN))
+    {
+        cerr << "SyntheticGraph!> dist weights need a knn graph" << endl;
+        return 0;
+    }
+    if ((wgt_kind==SYNTHETIC_WGT_INT) && (max_wgt<1))
+    {
+        cerr << "SyntheticGraph!> int weights need max_wgt>=1" << endl;
+        return 0;
+    }
+    if ((kind==SYNTHETIC_POWERLAW) && (!(gamma>1)))
+    {
+        cerr << "SyntheticGraph!> powerlaw needs gamma>1" << endl;
+        return 0;
+    }
+
+    /* expected edges of the rows, to balance the chunks */
+    row_vec.assign(num_node, 0.0);
+    num_left = num_node/2;
+    prob = 0.0;
+    switch (kind)
+    {
+        case SYNTHETIC_RANDOM:
+            prob = (num_node>1) ? min(1.0, max(avg_deg, 0.0)/(num_node - 1)) : 0.0;
+            for (i=0; i<num_node; i++)
+            {
+                row_vec[i] = prob*(num_node - 1 - i);
+            }
+            break;
+        case SYNTHETIC_DENSE:
+            prob = 1.0;
+            for (i=0; i<num_node; i++)
+            {
+                row_vec[i] = num_node - 1 - i;
+            }
+            break;
+        case SYNTHETIC_BIPARTITE:
+            prob = (num_left>0) ? min(1.0, 0.5*max(avg_deg, 0.0)*num_node/(double(num_left)*(num_node - num_left))) : 0.0;
+            for (i=0; i<num_left; i++)
+            {
+                row_vec[i] = prob*(num_node - num_left);
+            }
+            break;
+        case SYNTHETIC_POWERLAW:
+            /* node weights summing to avg_deg*num_node, the expected sum
+             * of the degrees */
+            node_wgt_vec.resize(num_node);
+            sum = 0.0;
+            for (i=0; i<num_node; i++)
+            {
+                node_wgt_vec[i] = pow(1.0 + i, -1.0/(gamma - 1.0));
+                sum += node_wgt_vec[i];
+            }
+            sum_wgt = max(avg_deg, 0.0)*num_node;
+            for (i=0; i<num_node; i++)
+            {
+                node_wgt_vec[i] *= (sum>0) ? sum_wgt/sum : 0.0;
+            }
+            sum = sum_wgt;
+            for (i=0; i<num_node; i++)
+            {
+                sum -= node_wgt_vec[i];
+                row_vec[i] = (sum_wgt>0) ? node_wgt_vec[i]*max(sum, 0.0)/sum_wgt : 0.0;
+            }
+            break;
+        case SYNTHETIC_BLOCK:
+            block_size = max(block_size, 2);
+            for (i=0; i<num_node; i++)
+            {
+                row_vec[i] = min(num_node, (i/block_size + 1)*block_size) - 1 - i;
+            }
+            break;
+        case SYNTHETIC_KNN:
+            knn = max(0, min(knn, num_node - 1));
+            for (i=0; i<num_node; i++)
+            {
+                row_vec[i] = knn;
+            }
+
+            /* points, and a grid of about 2 points per cell */
+            point_vec.resize(2*num_node);
+            for (i=0; i<2*num_node; i++)
+            {
+                point_vec[i] = 1.0 - rnd.uniform();
+            }
+            num_grid = max(1, int(sqrt(0.5*num_node)));
+            cell_begin_vec.assign(num_grid*num_grid + 1, 0);
+            for (i=0; i<num_node; i++)
+            {
+                k = min(int(point_vec[2*i+1]*num_grid), num_grid - 1)*num_grid + min(int(point_vec[2*i+0]*num_grid), num_grid - 1);
+                cell_begin_vec[k+1] += 1;
+            }
+            for (k=0; k<num_grid*num_grid; k++)
+            {
+                cell_begin_vec[k+1] += cell_begin_vec[k];
+            }
+            cell_end_vec.assign(cell_begin_vec.begin(), cell_begin_vec.end() - 1);
+            cell_point_vec.resize(num_node);
+            for (i=0; i<num_node; i++)
+            {
+                k = min(int(point_vec[2*i+1]*num_grid), num_grid - 1)*num_grid + min(int(point_vec[2*i+0]*num_grid), num_grid - 1);
+                cell_point_vec[cell_end_vec[k]++] = i;
+            }
+            break;
+    }
+
+    /* chunks of about SYNTHETIC_CHUNK_EDGES expected edges */
+    total = 0.0;
+    for (i=0; i<num_node; i++)
+    {
+        total += row_vec[i];
+    }
+    num_edge = total;
+    n_chunk = int(min(double(max(num_node, 1)), max(1.0, ceil(total/SYNTHETIC_CHUNK_EDGES))));
+    chunk_begin_vec.assign(1, 0);
+    sum = 0.0;
+    c = 1;
+    for (i=0; i<num_node; i++)
+    {
+        sum += row_vec[i];
+        if ((c<n_chunk) && (sum>=c*total/n_chunk))
+        {
+            chunk_begin_vec.push_back(i + 1);
+            c += 1;
+        }
+    }
+    if (chunk_begin_vec.back()<num_node)
+    {
+        chunk_begin_vec.push_back(num_node);
+    }
+    return 1;
+}
+/* end init */
+
+
+/* weight of an edge of length dist */
+double SyntheticGraph::
+edge_wgt(SyntheticRand & rnd, const double & dist) const
+{
+    switch (wgt_kind)
+    {
+        case SYNTHETIC_WGT_EXP:
+            return -max_wgt*log(rnd.uniform());
+        case SYNTHETIC_WGT_INT:
+            return 1.0 + rnd.below(int(max_wgt));
+        case SYNTHETIC_WGT_CONST:
+            return max_wgt;
+        case SYNTHETIC_WGT_DIST:
+            /* neighbours are about 1/sqrt(num_node) apart */
+            return max_wgt/(1.0 + dist*sqrt(double(num_node)));
+    }
+    return max_wgt*rnd.uniform();
+}
+/* end edge_wgt */
+
+
+/* knn nearest points of point i, by distance and then index, searching
+ * the rings of cells around the cell of i */
+void SyntheticGraph::
+nearest(const int & i, vector< pair<double,int> > & nbr_vec) const
+{
+    register int k;
+    register int j;
+    int         r;
+    int         cx;
+    int         cy;
+    int         gx;
+    int         gy;
+    double      dx;
+    double      dy;
+    pair<double,int> nbr;
+
+    nbr_vec.clear();
+    cx = min(int(point_vec[2*i+0]*num_grid), num_grid - 1);
+    cy = min(int(point_vec[2*i+1]*num_grid), num_grid - 1);
+    for (r=0; r<=num_grid; r++)
+    {
+        /* the points beyond ring r-1 are at least (r-1)/num_grid away */
+        if ((int(nbr_vec.size())==knn) && ((knn==0) || (nbr_vec.front().first<=double(r-1)/num_grid)))
+        {
+            break;
+        }
+        for (gy=cy-r; gy<=cy+r; gy++)
+        {
+            if ((gy<0) || (gy>=num_grid))
+            {
+                continue;
+            }
+            for (gx=cx-r; gx<=cx+r; gx++)
+            {
+                if ((gx<0) || (gx>=num_grid) || ((abs(gx - cx)<r) && (abs(gy - cy)<r)))
+                {
+                    continue;
+                }
+                for (k=cell_begin_vec[gy*num_grid+gx]; k<cell_begin_vec[gy*num_grid+gx+1]; k++)
+                {
+                    j = cell_point_vec[k];
+                    if (j==i)
+                    {
+                        continue;
+                    }
+                    dx = point_vec[2*j+0] - point_vec[2*i+0];
+                    dy = point_vec[2*j+1] - point_vec[2*i+1];
+                    nbr = make_pair(sqrt(dx*dx + dy*dy), j);
+                    if (int(nbr_vec.size())<knn)
+                    {
+                        nbr_vec.push_back(nbr);
+                        push_heap(nbr_vec.begin(), nbr_vec.end());
+                    }
+                    else if ((knn>0) && (nbr<nbr_vec.front()))
+                    {
+                        pop_heap(nbr_vec.begin(), nbr_vec.end());
+                        nbr_vec.back() = nbr;
+                        push_heap(nbr_vec.begin(), nbr_vec.end());
+                    }
+                }
+            }
+        }
+    }
+    sort_heap(nbr_vec.begin(), nbr_vec.end());
+}
+/* end nearest */
+
+
+/* edges of chunk c */
+void SyntheticGraph::
+chunk_ijw(const int & c, int & num_ijw, DoubleVec & ijw_vec) const
+{
+    register int i;
+    register int j;
+    register int k;
+    int         lo;
+    int         hi;
+    double      p;
+    double      q;
+    double      log_q;
+    bool        is_mutual;
+    vector< pair<double,int> > nbr_vec;
+    vector< pair<double,int> > nbr_j_vec;
+    SyntheticRand rnd(synthetic_chunk_seed(seed, c));
+
+    ijw_vec.clear();
+    for (i=chunk_begin_vec[c]; i<chunk_begin_vec[c+1]; i++)
+    {
+        switch (kind)
+        {
+            case SYNTHETIC_RANDOM:
+            case SYNTHETIC_DENSE:
+            case SYNTHETIC_BIPARTITE:
+                /* geometric skips between the edges (Batagelj-Brandes) */
+                lo = (kind==SYNTHETIC_BIPARTITE) ? max(i + 1, num_node/2) : i + 1;
+                hi = ((kind==SYNTHETIC_BIPARTITE) && (i>=num_node/2)) ? lo : num_node;
+                if (!(prob>0))
+                {
+                    break;
+                }
+                log_q = (prob<1) ? log(1.0 - prob) : 0.0;
+                for (j=lo; j<hi; j++)
+                {
+                    if (prob<1)
+                    {
+                        j += int(min(floor(log(rnd.uniform())/log_q), double(hi)));
+                        if (j>=hi)
+                        {
+                            break;
+                        }
+                    }
+                    ijw_vec.push_back(i);
+                    ijw_vec.push_back(j);
+                    ijw_vec.push_back(edge_wgt(rnd, 0.0));
+                }
+                break;
+            case SYNTHETIC_POWERLAW:
+                /* skips with the probability of the next node, which is an
+                 * upper bound for the nodes after it (Miller-Hagberg) */
+                j = i + 1;
+                p = (j<num_node) ? min(1.0, node_wgt_vec[i]*node_wgt_vec[j]/sum_wgt) : 0.0;
+                while ((j<num_node) && (p>0))
+                {
+                    if (p<1)
+                    {
+                        j += int(min(floor(log(rnd.uniform())/log(1.0 - p)), double(num_node)));
+                    }
+                    if (j>=num_node)
+                    {
+                        break;
+                    }
+                    q = min(1.0, node_wgt_vec[i]*node_wgt_vec[j]/sum_wgt);
+                    if (rnd.uniform()<=q/p)
+                    {
+                        ijw_vec.push_back(i);
+                        ijw_vec.push_back(j);
+                        ijw_vec.push_back(edge_wgt(rnd, 0.0));
+                    }
+                    p = q;
+                    j += 1;
+                }
+                break;
+            case SYNTHETIC_BLOCK:
+                for (j=i+1; j<min(num_node, (i/block_size + 1)*block_size); j++)
+                {
+                    ijw_vec.push_back(i);
+                    ijw_vec.push_back(j);
+                    ijw_vec.push_back(edge_wgt(rnd, 0.0));
+                }
+                break;
+            case SYNTHETIC_KNN:
+                /* an edge of both i and j is added by the smaller node */
+                nearest(i, nbr_vec);
+                for (k=0; k<int(nbr_vec.size()); k++)
+                {
+                    j = nbr_vec[k].second;
+                    if (j<i)
+                    {
+                        nearest(j, nbr_j_vec);
+                        is_mutual = false;
+                        for (lo=0; lo<int(nbr_j_vec.size()); lo++)
+                        {
+                            is_mutual = is_mutual || (nbr_j_vec[lo].second==i);
+                        }
+                        if (is_mutual)
+                        {
+                            continue;
+                        }
+                    }
+                    ijw_vec.push_back(min(i, j));
+                    ijw_vec.push_back(max(i, j));
+                    ijw_vec.push_back(edge_wgt(rnd, nbr_vec[k].first));
+                }
+                break;
+        }
+    }
+    num_ijw = int(ijw_vec.size()/3);
+}
+/* end chunk_ijw */
+
+
+/* kind of a synthetic graph by name, 0 if unknown */
+int synthetic_kind(const string & name)
+{
+    register int kind;
+    for (kind=1; kind<=SYNTHETIC_NUM_KIND; kind++)
+    {
+        if (name==synthetic_name(kind))
+        {
+            return kind;
+        }
+    }
+    return 0;
+}
+/* end synthetic_kind */
+
+
+/* name of a kind of synthetic graph */
+string synthetic_name(const int & kind)
+{
+    switch (kind)
+    {
+        case SYNTHETIC_RANDOM:
+            return string("random");
+        case SYNTHETIC_POWERLAW:
+            return string("powerlaw");
+        case SYNTHETIC_BLOCK:
+            return string("block");
+        case SYNTHETIC_DENSE:
+            return string("dense");
+        case SYNTHETIC_BIPARTITE:
+            return string("bipartite");
+        case SYNTHETIC_KNN:
+            return string("knn");
+    }
+    return string("unknown");
+}
+/* end synthetic_name */
+
+
+/* distribution of the weights by name, 0 if unknown */
+int synthetic_wgt_kind(const string & name)
+{
+    const char * wgt_name[] = {"uniform", "exp", "int", "const", "dist"};
+    register int k;
+    for (k=0; k<SYNTHETIC_WGT_NUM_KIND; k++)
+    {
+        if (name==wgt_name[k])
+        {
+            return k + 1;
+        }
+    }
+    return 0;
+}
+/* end synthetic_wgt_kind */
+
+
+/* synthetic graph of num_node nodes drawn from seed */
+int synthetic_ijw(const int & kind, const int & num_node, const double & avg_deg, const unsigned int & seed, int & num_ijw, DoubleVec & ijw_vec)
+{
+    register int c;
+    int         num_chunk_ijw;
+    DoubleVec   chunk_vec;
+    SyntheticGraph G;
+
+    num_ijw = 0;
+    ijw_vec.clear();
+    G.kind = kind;
+    G.num_node = num_node;
+    G.avg_deg = avg_deg;
+    G.knn = int(avg_deg + 0.5);
+    G.block_size = int(avg_deg) + 1;
+    G.seed = seed;
+    if (!G.init())
+    {
+        return 0;
+    }
+    for (c=0; c<G.num_chunk(); c++)
+    {
+        G.chunk_ijw(c, num_chunk_ijw, chunk_vec);
+        ijw_vec.insert(ijw_vec.end(), chunk_vec.begin(), chunk_vec.end());
+        num_ijw += num_chunk_ijw;
+    }
+    return 1;
+}
+/* end synthetic_ijw */
+
@@ -0,0 +1,280 @@
+/*
+ * B-matching toolbox
+ * Stuart Andrews
+ * */
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "verifybmatch.hpp"
+
+
+/* relative tolerance of the reported weight */
+#define VERIFY_WGT_TOL (1e-6)
+
+
+/* */
+int BmatchVerification::
+num_violation() const
+{
+    return num_bad_edge + num_dup_edge + num_over_node + num_under_node + int(wgt_error>VERIFY_WGT_TOL*max(1.0, fabs(wgt)));
+}
+/* end num_violation */
+
+
+/* */
+void BmatchVerification::
+write(ostream & out, const string & prefix, const int & is_bound) const
+{
+    if (is_bound)
+    {
+        out << prefix << "wgt " << wgt << ", upper bound " << upper_bound << ", ratio >= " << ratio << endl;
+    }
+    else
+    {
+        out << prefix << "wgt " << wgt << endl;
+    }
+    if (num_bad_edge>0)
+    {
+        out << prefix << num_bad_edge << " matched edges not in the graph" << endl;
+    }
+    if (num_dup_edge>0)
+    {
+        out << prefix << num_dup_edge << " matched edges listed twice" << endl;
+    }
+    if (num_over_node>0)
+    {
+        out << prefix << num_over_node << " nodes over their upper bound, by " << excess << endl;
+    }
+    if (num_under_node>0)
+    {
+        out << prefix << num_under_node << " nodes under their lower bound, by " << deficit << endl;
+    }
+    if (wgt_error>VERIFY_WGT_TOL*max(1.0, fabs(wgt)))
+    {
+        out << prefix << "reported wgt is off by " << wgt_error << endl;
+    }
+}
+/* end write */
+
+
+/*
+ * the entries of the ijw and the matched edges are bucketed by the lower
+ * node a of each pair (a,b); a row at a time, the weights of the edges
+ * (a,b) of the graph are added up in wgt_vec[b], marked by row_vec[b] = a,
+ * and looked up by the matched edges of the row
+ * */
+void verify_bmatching(const int & num_node, const DoubleVec & deg_bdd_vec, const int & num_ijw, const IjwView & ijw_view, const int & num_bmatch_edge, const DoubleVec & bmatch_edge_vec, const double & bmatch_wgt, const int & is_full, BmatchVerification & V)
+{
+    register int i;
+    register int j;
+    register int k;
+    register int kk;
+    int a;
+    int b;
+    int cap;
+    double lb;
+    double ub;
+    double top;
+    vector<int> ijw_begin_vec(num_node+1, 0);
+    vector<int> ijw_index_vec;
+    vector<int> edge_begin_vec(num_node+1, 0);
+    vector<int> edge_index_vec;
+    vector<int> row_vec(num_node, -1);
+    vector<int> used_vec(num_node, -1);
+    vector<int> used_lower_vec(num_node, -1);
+    DoubleVec   wgt_vec(num_node, 0.0);
+    vector<int> deg_vec(num_node, 0);
+    vector<int> nbr_begin_vec(num_node+1, 0);
+    vector<int> nbr_end_vec;
+    DoubleVec   nbr_wgt_vec;
+    vector<int> uniq_a_vec;
+    vector<int> uniq_b_vec;
+    DoubleVec   uniq_wgt_vec;
+
+    V.num_bad_edge = 0;
+    V.num_dup_edge = 0;
+    V.num_over_node = 0;
+    V.num_under_node = 0;
+    V.excess = 0.0;
+    V.deficit = 0.0;
+    V.wgt = 0.0;
+    V.upper_bound = 0.0;
+
+    /* entries of the graph, by row */
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_view.i(k));
+        j = int(ijw_view.j(k));
+        if ((i<=j) && (i>=0) && (j<num_node))
+        {
+            ijw_begin_vec[i+1] += 1;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        ijw_begin_vec[i+1] += ijw_begin_vec[i];
+    }
+    ijw_index_vec.resize(ijw_begin_vec[num_node]);
+    nbr_end_vec.assign(ijw_begin_vec.begin(), ijw_begin_vec.end());
+    for (k=0; k<num_ijw; k++)
+    {
+        i = int(ijw_view.i(k));
+        j = int(ijw_view.j(k));
+        if ((i<=j) && (i>=0) && (j<num_node))
+        {
+            ijw_index_vec[nbr_end_vec[i]++] = k;
+        }
+    }
+
+    /* matched edges, by lower node */
+    for (k=0; k<num_bmatch_edge; k++)
+    {
+        i = int(bmatch_edge_vec[3*k+0]);
+        j = int(bmatch_edge_vec[3*k+1]);
+        if ((i<0) || (j<0) || (i>=num_node) || (j>=num_node))
+        {
+            V.num_bad_edge++;
+            continue;
+        }
+        edge_begin_vec[min(i,j)+1] += 1;
+    }
+    for (i=0; i<num_node; i++)
+    {
+        edge_begin_vec[i+1] += edge_begin_vec[i];
+    }
+    edge_index_vec.resize(edge_begin_vec[num_node]);
+    nbr_end_vec.assign(edge_begin_vec.begin(), edge_begin_vec.end());
+    for (k=0; k<num_bmatch_edge; k++)
+    {
+        i = int(bmatch_edge_vec[3*k+0]);
+        j = int(bmatch_edge_vec[3*k+1]);
+        if ((i>=0) && (j>=0) && (i<num_node) && (j<num_node))
+        {
+            edge_index_vec[nbr_end_vec[min(i,j)]++] = k;
+        }
+    }
+
+    /* a row at a time: the edges of the graph, then the matched edges */
+    for (a=0; a<num_node; a++)
+    {
+        for (kk=ijw_begin_vec[a]; kk<ijw_begin_vec[a+1]; kk++)
+        {
+            b = int(ijw_view.j(ijw_index_vec[kk]));
+            if (row_vec[b]!=a)
+            {
+                row_vec[b] = a;
+                wgt_vec[b] = 0.0;
+                uniq_a_vec.push_back(a);
+                uniq_b_vec.push_back(b);
+            }
+            wgt_vec[b] += ijw_view.w(ijw_index_vec[kk]);
+        }
+        for (kk=int(uniq_wgt_vec.size()); kk<int(uniq_b_vec.size()); kk++)
+        {
+            uniq_wgt_vec.push_back(wgt_vec[uniq_b_vec[kk]]);
+        }
+
+        for (kk=edge_begin_vec[a]; kk<edge_begin_vec[a+1]; kk++)
+        {
+            k = edge_index_vec[kk];
+            i = int(bmatch_edge_vec[3*k+0]);
+            j = int(bmatch_edge_vec[3*k+1]);
+            b = max(i,j);
+            if (is_full)
+            {
+                deg_vec[i] += 1;
+            }
+            else
+            {
+                deg_vec[a] += 1;
+                deg_vec[b] += 1;
+            }
+            if ((row_vec[b]!=a) || (wgt_vec[b]==0))
+            {
+                V.num_bad_edge++;
+                continue;
+            }
+            /* with is_full, (i,j) and (j,i) are different entries */
+            if (is_full && (i>j))
+            {
+                if (used_lower_vec[b]==a)
+                {
+                    V.num_dup_edge++;
+                    continue;
+                }
+                used_lower_vec[b] = a;
+            }
+            else
+            {
+                if (used_vec[b]==a)
+                {
+                    V.num_dup_edge++;
+                    continue;
+                }
+                used_vec[b] = a;
+            }
+            V.wgt += (is_full ? 0.5 : 1.0)*wgt_vec[b];
+        }
+    }
+
+    /* degree bounds */
+    for (i=0; i<num_node; i++)
+    {
+        lb = deg_bdd_vec[2*i+0];
+        ub = deg_bdd_vec[2*i+1];
+        if (deg_vec[i]>ub)
+        {
+            V.num_over_node++;
+            V.excess += deg_vec[i] - ub;
+        }
+        if ((lb>0) && (deg_vec[i]<lb))
+        {
+            V.num_under_node++;
+            V.deficit += lb - deg_vec[i];
+        }
+    }
+    V.wgt_error = fabs(bmatch_wgt - V.wgt);
+
+    /* LP bound: the positive edges of each node, of which the u_i
+     * heaviest; a self-loop is listed twice, as it takes 2 of the degree */
+    for (k=0; k<int(uniq_a_vec.size()); k++)
+    {
+        if (uniq_wgt_vec[k]>0)
+        {
+            nbr_begin_vec[uniq_a_vec[k]+1] += 1;
+            nbr_begin_vec[uniq_b_vec[k]+1] += 1;
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        nbr_begin_vec[i+1] += nbr_begin_vec[i];
+    }
+    nbr_wgt_vec.resize(nbr_begin_vec[num_node]);
+    nbr_end_vec.assign(nbr_begin_vec.begin(), nbr_begin_vec.end());
+    for (k=0; k<int(uniq_a_vec.size()); k++)
+    {
+        if (uniq_wgt_vec[k]>0)
+        {
+            nbr_wgt_vec[nbr_end_vec[uniq_a_vec[k]]++] = uniq_wgt_vec[k];
+            nbr_wgt_vec[nbr_end_vec[uniq_b_vec[k]]++] = uniq_wgt_vec[k];
+        }
+    }
+    for (i=0; i<num_node; i++)
+    {
+        cap = nbr_begin_vec[i+1] - nbr_begin_vec[i];
+        if (deg_bdd_vec[2*i+1]<cap)
+        {
+            cap = max(int(floor(deg_bdd_vec[2*i+1])), 0);
+            nth_element(nbr_wgt_vec.begin() + nbr_begin_vec[i], nbr_wgt_vec.begin() + nbr_begin_vec[i] + cap, nbr_wgt_vec.begin() + nbr_begin_vec[i+1], greater<double>());
+        }
+        top = 0.0;
+        for (k=nbr_begin_vec[i]; k<nbr_begin_vec[i]+cap; k++)
+        {
+            top += nbr_wgt_vec[k];
+        }
+        V.upper_bound += 0.5*top;
+    }
+    V.ratio = (V.upper_bound>0) ? V.wgt/V.upper_bound : 1.0;
+}
+/* end verify_bmatching */
+